@@ -4,14 +4,49 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <inttypes.h>
+#include <limits.h>
 #include <string.h>
+#include <strings.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 #ifndef _WIN32
 	#include <dirent.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
 	#include <pthread.h>
 	#include <semaphore.h>
+	#include <sys/file.h>
+	#include <sys/ioctl.h>
+#endif
+#if defined(__linux__)
+	#include <linux/fs.h>
+	#include <linux/falloc.h>
+	#include <sys/syscall.h>
+#elif defined(__APPLE__)
+	#include <sys/clonefile.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP>=2
+	#include <emmintrin.h>
+	#define SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define SIMD_NEON
+#endif
+//instructions not every processor of the architecture has, compiled in regardless and used only once checked for
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <cpuid.h>
+	#include <immintrin.h>
+	#define CPU_X86
+#elif defined(__GNUC__) && defined(__aarch64__)
+	#include <arm_acle.h>
+	#if defined(__linux__)
+		#include <sys/auxv.h>
+		#include <asm/hwcap.h>
+	#endif
+	#define CPU_ARM64
 #endif
 
 #include <curl/curl.h>
@@ -19,14 +54,15 @@
 #ifdef _WIN32
 	//this has to be AFTER curl
 	#include <windows.h>
+	#include <io.h>
 	#define strdup _strdup
 #endif
 
 #include "lib/cfgpath/cfgpath.h"
 #include "lib/jsmn/jsmn.h"
 #include "lib/libui/ui.h"
-#include "lib/semver.c/semver.h"
-#include "lib/zip/src/zip.h"
+#define MINIZ_HEADER_FILE_ONLY
+#include "lib/zip/src/miniz.h"
 
 #define PROGRAM_NAME    "electron-shared"
 #define PROGRAM_VERSION "0.1-alpha"
@@ -71,13 +107,594 @@ unsigned long getTime() {
 	return now.tv_sec*1000 + now.tv_usec/1000.0;
 }
 
+// settings are read from the environment, as ELECTRON_SHARED_<NAME>, or otherwise from "<NAME> = <value>" lines in a "config" file in the cache folder
+
+typedef struct {
+	const char *name;
+	const char *value;
+} _Config_setting;
+
+static char *_configFile = NULL;                  //the config file, with each name and value terminated in place
+static _Config_setting *_configSettings = NULL;
+static unsigned _configSettingCount = 0;
+static bool _configFileRead = false;
+
+static char *_config_trim(char *start, char *end) {
+	while(start<end && (*start==' '||*start=='\t')) start++;
+	while(end>start && (end[-1]==' '||end[-1]=='\t')) end--;
+	*end = '\0';
+	return start;
+}
+
+static void _config_file_read() {
+	_configFileRead = true;
+
+	char filename[MAX_PATH+16];
+	get_user_cache_folder(filename, MAX_PATH, PROGRAM_NAME);
+	if(!filename[0]) return;
+	strcat(filename, "config");
+
+	FILE *file = fopen(filename, "rb");
+	if(!file) return;
+
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	_configFile = length>0?malloc(length+1):NULL;
+	if(!_configFile || fread(_configFile, 1, length, file)!=length){
+		free(_configFile);
+		_configFile = NULL;
+		fclose(file);
+		return;
+	}
+	fclose(file);
+
+	_configFile[length] = '\0';
+
+	unsigned lineCount = 1;
+	for(char *c=_configFile; *c; c++){
+		if(*c=='\n') lineCount++;
+	}
+
+	_configSettings = calloc(lineCount, sizeof(_Config_setting));
+
+	for(char *line=_configFile; *line;){
+		char *lineEnd = line+strcspn(line, "\r\n");
+		char *next = *lineEnd?lineEnd+1:lineEnd;
+
+		char *equals = memchr(line, '=', lineEnd-line);
+		if(line[0]!='#' && equals){
+			_Config_setting *setting = &_configSettings[_configSettingCount];
+			setting->name = _config_trim(line, equals);
+			setting->value = _config_trim(equals+1, lineEnd);
+
+			if(setting->name[0]){
+				_configSettingCount++;
+			}
+		}
+
+		line = next;
+	}
+}
+
+// forgets the config file, so it's read again when next needed
+void config_reload() {
+	free(_configFile);
+	free(_configSettings);
+	_configFile = NULL;
+	_configSettings = NULL;
+	_configSettingCount = 0;
+	_configFileRead = false;
+}
+
+const char *config_get(const char *name) {
+	char variable[128];
+	snprintf(variable, sizeof(variable), "ELECTRON_SHARED_%s", name);
+
+	const char *value = getenv(variable);
+	if(value&&*value) return value;
+
+	if(!_configFileRead){
+		_config_file_read();
+	}
+
+	//later lines take precedence
+	for(unsigned i=_configSettingCount; i-->0;){
+		if(!strcmp(_configSettings[i].name, name)) return _configSettings[i].value[0]?_configSettings[i].value:NULL;
+	}
+
+	return NULL;
+}
+
+long config_get_number(const char *name, long fallback) {
+	const char *value = config_get(name);
+	if(!value) return fallback;
+
+	char *end;
+	long number = strtol(value, &end, 10);
+	return end!=value?number:fallback;
+}
+
+uint64_t hash_bytes(const void *data, size_t length) {
+	//FNV-1a
+	uint64_t hash = 0xcbf29ce484222325;
+	for(const uint8_t *byte=data; length--; byte++){
+		hash = (hash^*byte)*0x100000001b3;
+	}
+	return hash;
+}
+
+uint64_t hash_string(const char *string) {
+	return hash_bytes(string, strlen(string));
+}
+
+// SHA-256, for naming content that has to be told apart reliably
+
+typedef struct {
+	uint32_t state[8];
+	uint64_t length;          //bytes hashed so far
+	uint8_t block[64];
+} Sha256;
+
+static const uint32_t _sha256_constants[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define _SHA256_ROTATE(x, n) ((x)>>(n) | (x)<<(32-(n)))
+
+static void _sha256_blocks_portable(uint32_t state[8], const uint8_t *data, size_t blocks) {
+	for(; blocks--; data+=64){
+		uint32_t w[64];
+		for(unsigned i=0; i<16; i++){
+			w[i] = (uint32_t)data[i*4]<<24 | (uint32_t)data[i*4+1]<<16 | (uint32_t)data[i*4+2]<<8 | data[i*4+3];
+		}
+		for(unsigned i=16; i<64; i++){
+			uint32_t s0 = _SHA256_ROTATE(w[i-15], 7)^_SHA256_ROTATE(w[i-15], 18)^w[i-15]>>3;
+			uint32_t s1 = _SHA256_ROTATE(w[i-2], 17)^_SHA256_ROTATE(w[i-2], 19)^w[i-2]>>10;
+			w[i] = w[i-16]+s0+w[i-7]+s1;
+		}
+
+		uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+		uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+		for(unsigned i=0; i<64; i++){
+			uint32_t t1 = h+(_SHA256_ROTATE(e, 6)^_SHA256_ROTATE(e, 11)^_SHA256_ROTATE(e, 25))+(e&f^~e&g)+_sha256_constants[i]+w[i];
+			uint32_t t2 = (_SHA256_ROTATE(a, 2)^_SHA256_ROTATE(a, 13)^_SHA256_ROTATE(a, 22))+(a&b^a&c^b&c);
+			h = g; g = f; f = e; e = d+t1;
+			d = c; c = b; b = a; a = t1+t2;
+		}
+
+		state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+		state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+	}
+}
+
+#if defined(CPU_X86)
+	// the SHA extensions keep the state as ABEF and CDGH, and take four rounds of the schedule at a time
+	__attribute__((target("sha,sse4.1")))
+	static void _sha256_blocks_x86(uint32_t state[8], const uint8_t *data, size_t blocks) {
+		const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+		__m128i cdab = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xB1);
+		__m128i efgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1B);
+		__m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+		__m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xF0);
+
+		for(; blocks--; data+=64){
+			__m128i abefSaved = abef;
+			__m128i cdghSaved = cdgh;
+
+			//each of the last four groups of the schedule, with group i kept in w[i%4]
+			__m128i w[4];
+
+			for(unsigned i=0; i<16; i++){
+				if(i<4){
+					w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data+i*16)), byteSwap);
+				}else{
+					__m128i next = _mm_sha256msg1_epu32(w[i%4], w[(i+1)%4]);
+					next = _mm_add_epi32(next, _mm_alignr_epi8(w[(i+3)%4], w[(i+2)%4], 4));
+					w[i%4] = _mm_sha256msg2_epu32(next, w[(i+3)%4]);
+				}
+
+				__m128i rounds = _mm_add_epi32(w[i%4], _mm_loadu_si128((const __m128i*)&_sha256_constants[i*4]));
+				cdgh = _mm_sha256rnds2_epu32(cdgh, abef, rounds);
+				abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(rounds, 0x0E));
+			}
+
+			abef = _mm_add_epi32(abef, abefSaved);
+			cdgh = _mm_add_epi32(cdgh, cdghSaved);
+		}
+
+		__m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+		__m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+		_mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(feba, dchg, 0xF0));
+		_mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(dchg, feba, 8));
+	}
+
+#elif defined(CPU_ARM64)
+	#ifdef __clang__
+		__attribute__((target("crypto")))
+	#else
+		__attribute__((target("+crypto")))
+	#endif
+	static void _sha256_blocks_arm64(uint32_t state[8], const uint8_t *data, size_t blocks) {
+		uint32x4_t abcd = vld1q_u32(&state[0]);
+		uint32x4_t efgh = vld1q_u32(&state[4]);
+
+		for(; blocks--; data+=64){
+			uint32x4_t abcdSaved = abcd;
+			uint32x4_t efghSaved = efgh;
+
+			//each of the last four groups of the schedule, with group i kept in w[i%4]
+			uint32x4_t w[4];
+
+			for(unsigned i=0; i<16; i++){
+				if(i<4){
+					w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data+i*16)));
+				}else{
+					w[i%4] = vsha256su1q_u32(vsha256su0q_u32(w[i%4], w[(i+1)%4]), w[(i+2)%4], w[(i+3)%4]);
+				}
+
+				uint32x4_t rounds = vaddq_u32(w[i%4], vld1q_u32(&_sha256_constants[i*4]));
+				uint32x4_t abcdPrevious = abcd;
+				abcd = vsha256hq_u32(abcd, efgh, rounds);
+				efgh = vsha256h2q_u32(efgh, abcdPrevious, rounds);
+			}
+
+			abcd = vaddq_u32(abcd, abcdSaved);
+			efgh = vaddq_u32(efgh, efghSaved);
+		}
+
+		vst1q_u32(&state[0], abcd);
+		vst1q_u32(&state[4], efgh);
+	}
+#endif
+
+// whether the processor has instructions for SHA-256
+bool cpu_has_sha256() {
+	#if defined(CPU_X86)
+		unsigned a, b, c, d;
+		if(!__get_cpuid(1, &a, &b, &c, &d) || !(c&bit_SSSE3) || !(c&bit_SSE4_1)) return false;
+		return __get_cpuid_count(7, 0, &a, &b, &c, &d) && (b&bit_SHA);
+	#elif defined(CPU_ARM64) && defined(_WIN32)
+		return IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE);
+	#elif defined(CPU_ARM64) && defined(__APPLE__)
+		return true; //every Apple processor has them
+	#elif defined(CPU_ARM64) && defined(__linux__)
+		return getauxval(AT_HWCAP)&HWCAP_SHA2;
+	#else
+		return false;
+	#endif
+}
+
+typedef void (*_Sha256_blocks)(uint32_t state[8], const uint8_t *data, size_t blocks);
+
+// the fastest of the above the processor can run, chosen on first use (by any number of threads at once, each choosing the same)
+static _Sha256_blocks _sha256_blocks = NULL;
+
+static _Sha256_blocks _sha256_select() {
+	_Sha256_blocks blocks = __atomic_load_n(&_sha256_blocks, __ATOMIC_RELAXED);
+	if(blocks) return blocks;
+
+	#if defined(CPU_X86)
+		blocks = cpu_has_sha256()?_sha256_blocks_x86:_sha256_blocks_portable;
+	#elif defined(CPU_ARM64)
+		blocks = cpu_has_sha256()?_sha256_blocks_arm64:_sha256_blocks_portable;
+	#else
+		blocks = _sha256_blocks_portable;
+	#endif
+
+	__atomic_store_n(&_sha256_blocks, blocks, __ATOMIC_RELAXED);
+	return blocks;
+}
+
+void sha256_init(Sha256 *sha) {
+	static const uint32_t initial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+	memcpy(sha->state, initial, sizeof(initial));
+	sha->length = 0;
+}
+
+void sha256_update(Sha256 *sha, const void *data, size_t length) {
+	_Sha256_blocks blocks = _sha256_select();
+
+	const uint8_t *bytes = data;
+	size_t buffered = sha->length%64;
+	sha->length += length;
+
+	if(buffered){
+		size_t take = MIN(length, 64-buffered);
+		memcpy(sha->block+buffered, bytes, take);
+		bytes += take;
+		length -= take;
+
+		if(buffered+take<64) return;
+		blocks(sha->state, sha->block, 1);
+	}
+
+	blocks(sha->state, bytes, length/64);
+	memcpy(sha->block, bytes+length/64*64, length%64);
+}
+
+void sha256_finish(Sha256 *sha, uint8_t digest[32]) {
+	uint64_t bits = sha->length*8;
+
+	uint8_t padding[72] = {0x80};
+	size_t paddingLength = 64-(sha->length+8)%64;
+	for(unsigned i=0; i<8; i++){
+		padding[paddingLength+i] = bits>>(56-i*8);
+	}
+	sha256_update(sha, padding, paddingLength+8);
+
+	for(unsigned i=0; i<8; i++){
+		digest[i*4] = sha->state[i]>>24;
+		digest[i*4+1] = sha->state[i]>>16;
+		digest[i*4+2] = sha->state[i]>>8;
+		digest[i*4+3] = sha->state[i];
+	}
+}
+
+// CRC-32 (as zip uses), through the processor's own instructions where it has them, and miniz otherwise
+
+#if defined(CPU_X86)
+	// folds 64 bytes at a time by carry-less multiplication, then reduces what's left to 32 bits, as in Intel's "Fast CRC Computation Using PCLMULQDQ"
+	// takes and returns the CRC uninverted, for a `length` that's a multiple of 16, and at least 64
+	__attribute__((target("pclmul,sse4.1")))
+	static uint32_t _crc32_blocks_x86(uint32_t crc, const uint8_t *data, size_t length) {
+		const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+		const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+		const __m128i k5 = _mm_set_epi64x(0, 0x0163cd6124);
+		const __m128i polynomial = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+		const __m128i low32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+		#define _CRC32_FOLD(x, k, next) _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), next)
+
+		__m128i x1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)data), _mm_cvtsi32_si128(crc));
+		__m128i x2 = _mm_loadu_si128((const __m128i*)(data+16));
+		__m128i x3 = _mm_loadu_si128((const __m128i*)(data+32));
+		__m128i x4 = _mm_loadu_si128((const __m128i*)(data+48));
+		data += 64;
+		length -= 64;
+
+		for(; length>=64; data+=64, length-=64){
+			x1 = _CRC32_FOLD(x1, k1k2, _mm_loadu_si128((const __m128i*)data));
+			x2 = _CRC32_FOLD(x2, k1k2, _mm_loadu_si128((const __m128i*)(data+16)));
+			x3 = _CRC32_FOLD(x3, k1k2, _mm_loadu_si128((const __m128i*)(data+32)));
+			x4 = _CRC32_FOLD(x4, k1k2, _mm_loadu_si128((const __m128i*)(data+48)));
+		}
+
+		//down to 128 bits
+		x1 = _CRC32_FOLD(x1, k3k4, x2);
+		x1 = _CRC32_FOLD(x1, k3k4, x3);
+		x1 = _CRC32_FOLD(x1, k3k4, x4);
+
+		for(; length>=16; data+=16, length-=16){
+			x1 = _CRC32_FOLD(x1, k3k4, _mm_loadu_si128((const __m128i*)data));
+		}
+
+		#undef _CRC32_FOLD
+
+		//then 64
+		x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), _mm_clmulepi64_si128(x1, k3k4, 0x10));
+		x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, low32), k5, 0x00), _mm_srli_si128(x1, 4));
+
+		//and 32 (Barrett reduction)
+		__m128i x0 = _mm_clmulepi64_si128(_mm_and_si128(x1, low32), polynomial, 0x10);
+		x0 = _mm_clmulepi64_si128(_mm_and_si128(x0, low32), polynomial, 0x00);
+
+		return _mm_extract_epi32(_mm_xor_si128(x1, x0), 1);
+	}
+
+#elif defined(CPU_ARM64)
+	// takes and returns the CRC uninverted, for a `length` that's a multiple of 16
+	#ifdef __clang__
+		__attribute__((target("crc")))
+	#else
+		__attribute__((target("+crc")))
+	#endif
+	static uint32_t _crc32_blocks_arm64(uint32_t crc, const uint8_t *data, size_t length) {
+		for(; length>=16; data+=16, length-=16){
+			uint64_t first, second;
+			memcpy(&first, data, 8);
+			memcpy(&second, data+8, 8);
+			crc = __crc32d(__crc32d(crc, first), second);
+		}
+
+		return crc;
+	}
+#endif
+
+// whether the processor has instructions for CRC-32
+bool cpu_has_crc32() {
+	#if defined(CPU_X86)
+		unsigned a, b, c, d;
+		return __get_cpuid(1, &a, &b, &c, &d) && (c&bit_PCLMUL) && (c&bit_SSE4_1);
+	#elif defined(CPU_ARM64) && defined(_WIN32)
+		return IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE);
+	#elif defined(CPU_ARM64) && defined(__APPLE__)
+		return true;
+	#elif defined(CPU_ARM64) && defined(__linux__)
+		return getauxval(AT_HWCAP)&HWCAP_CRC32;
+	#else
+		return false;
+	#endif
+}
+
+#define CRC32_BLOCKS_MINIMUM 64 //shorter runs aren't worth the instructions' setup
+
+typedef uint32_t (*_Crc32_blocks)(uint32_t crc, const uint8_t *data, size_t length);
+
+static uint32_t _crc32_blocks_portable(uint32_t crc, const uint8_t *data, size_t length) {
+	return ~mz_crc32(~crc, data, length);
+}
+
+// whichever of the above the processor can run, chosen on first use (by any number of threads at once, each choosing the same)
+static _Crc32_blocks _crc32_blocks = NULL;
+
+static _Crc32_blocks _crc32_select() {
+	_Crc32_blocks blocks = __atomic_load_n(&_crc32_blocks, __ATOMIC_RELAXED);
+	if(blocks) return blocks;
+
+	blocks = _crc32_blocks_portable;
+	#if defined(CPU_X86)
+		if(cpu_has_crc32()) blocks = _crc32_blocks_x86;
+	#elif defined(CPU_ARM64)
+		if(cpu_has_crc32()) blocks = _crc32_blocks_arm64;
+	#endif
+
+	__atomic_store_n(&_crc32_blocks, blocks, __ATOMIC_RELAXED);
+	return blocks;
+}
+
+// continues `crc` (0 to begin with) over `length` bytes of `data`, as mz_crc32() does
+uint32_t crc32_update(uint32_t crc, const void *data, size_t length) {
+	_Crc32_blocks blocks = _crc32_select();
+	const uint8_t *bytes = data;
+
+	if(length>=CRC32_BLOCKS_MINIMUM){
+		size_t blocksLength = length&~(size_t)15;
+		crc = ~blocks(~crc, bytes, blocksLength);
+		bytes += blocksLength;
+		length -= blocksLength;
+	}
+
+	return length?mz_crc32(crc, bytes, length):crc;
+}
+
+void sleep_ms(unsigned milliseconds) {
+	#ifdef _WIN32
+		Sleep(milliseconds);
+	#else
+		usleep(milliseconds*1000);
+	#endif
+}
+
+#ifdef _WIN32
+	typedef HANDLE Thread;
+	typedef HANDLE Mutex;
+	typedef HANDLE Semaphore;
+
+	typedef struct {
+		void *(*function)(void*);
+		void *arg;
+	} _Thread_start;
+
+	static DWORD WINAPI _thread_main_win32(LPVOID lpParam) {
+		_Thread_start start = *(_Thread_start*)lpParam;
+		free(lpParam);
+
+		start.function(start.arg);
+		return 0;
+	}
+#else
+	typedef pthread_t Thread;
+	typedef pthread_mutex_t Mutex;
+	typedef sem_t Semaphore;
+#endif
+
+bool thread_start(Thread *thread, void *(*function)(void*), void *arg) {
+	#ifdef _WIN32
+		_Thread_start *start = malloc(sizeof(*start));
+		start->function = function;
+		start->arg = arg;
+
+		*thread = CreateThread(NULL, 0, _thread_main_win32, start, 0, NULL);
+		if(!*thread){
+			free(start);
+			return false;
+		}
+		return true;
+	#else
+		return !pthread_create(thread, NULL, function, arg);
+	#endif
+}
+
+void thread_join(Thread thread) {
+	#ifdef _WIN32
+		WaitForSingleObject(thread, INFINITE);
+		CloseHandle(thread);
+	#else
+		pthread_join(thread, NULL);
+	#endif
+}
+
+void mutex_init(Mutex *mutex) {
+	#ifdef _WIN32
+		*mutex = CreateMutex(NULL, FALSE, NULL);
+	#else
+		pthread_mutex_init(mutex, NULL);
+	#endif
+}
+
+void mutex_lock(Mutex *mutex) {
+	#ifdef _WIN32
+		WaitForSingleObject(*mutex, INFINITE);
+	#else
+		pthread_mutex_lock(mutex);
+	#endif
+}
+
+void mutex_unlock(Mutex *mutex) {
+	#ifdef _WIN32
+		ReleaseMutex(*mutex);
+	#else
+		pthread_mutex_unlock(mutex);
+	#endif
+}
+
+void mutex_free(Mutex *mutex) {
+	#ifdef _WIN32
+		CloseHandle(*mutex);
+	#else
+		pthread_mutex_destroy(mutex);
+	#endif
+}
+
+void semaphore_init(Semaphore *semaphore) {
+	#ifdef _WIN32
+		*semaphore = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+	#else
+		sem_init(semaphore, 0, 0);
+	#endif
+}
+
+void semaphore_post(Semaphore *semaphore, unsigned count) {
+	#ifdef _WIN32
+		if(count) ReleaseSemaphore(*semaphore, count, NULL);
+	#else
+		while(count--) sem_post(semaphore);
+	#endif
+}
+
+void semaphore_wait(Semaphore *semaphore) {
+	#ifdef _WIN32
+		WaitForSingleObject(*semaphore, INFINITE);
+	#else
+		while(sem_wait(semaphore)&&errno==EINTR);
+	#endif
+}
+
+void semaphore_free(Semaphore *semaphore) {
+	#ifdef _WIN32
+		CloseHandle(*semaphore);
+	#else
+		sem_destroy(semaphore);
+	#endif
+}
+
 #ifdef _WIN32
 	HANDLE ui_thread;
-	HANDLE _ui_mutex;
 	HANDLE _ui_loaded;
 #else
 	pthread_t ui_thread;
-	pthread_mutex_t _ui_mutex;
 	sem_t _ui_loaded;
 #endif
 
@@ -89,8 +706,43 @@ uiWindow *_ui_window = NULL;
 uiLabel *_ui_label = NULL;
 uiProgressBar *_ui_progress = NULL;
 
-//mutexed
-bool _ui_cancelled = false;
+// what's shown is written by any thread without allocating or locking, and sampled by the window thread on a timer
+// progress is summed over every share of it reported (each adding the change from what it reported last), so parallel installs and transfers show as one
+
+#define UI_SAMPLE_INTERVAL 100            //ms between the window thread sampling what to show
+#define UI_RATE_MINIMUM    (1024*1024)    //progress totalling less than this shows no rate (nor do percentages mirrored from another process)
+
+typedef struct {
+	const char *status; //must outlive the window, as with a string literal
+	uint64_t done;
+	uint64_t total;
+	unsigned updates;   //counted, so the window is only shown once there's something new
+	bool cancelled;
+} _Ui_state;
+
+static _Ui_state _uiState = {0};
+
+// one share of the progress shown, as reported by whatever owns it (a thread, or a single transfer)
+typedef struct {
+	uint64_t done;
+	uint64_t total;
+} Ui_share;
+
+static _Thread_local Ui_share _uiThreadShare = {0}; //what ui_progress() reports
+static _Thread_local Ui_share _uiThreadSum = {0};   //every share this thread reports, together, as the progress of whatever install it's running
+
+//for use in the window thread only
+typedef struct {
+	const char *status;   //as of the last sample
+	uint64_t done;
+	unsigned long time;
+	double rate;          //in bytes per second, smoothed over samples
+	unsigned hidden;      //updates as of the window last being hidden
+	int progress;         //as shown
+	char text[128];
+} _Ui_view;
+
+static _Ui_view _uiView;
 
 void _ui_on_cancel_clicked(uiButton *b, void *data) {
 	void ui_cancel();
@@ -105,6 +757,68 @@ int _ui_on_window_close(uiWindow *w, void *data) {
 	return 1;
 }
 
+// formats the time `seconds` left into `text`
+static void _ui_format_remaining(char *text, size_t size, double seconds) {
+	if(seconds<60){
+		snprintf(text, size, "%u s left", (unsigned)seconds+1);
+	}else if(seconds<60*60){
+		snprintf(text, size, "%u min left", (unsigned)(seconds/60)+1);
+	}else{
+		snprintf(text, size, "over an hour left");
+	}
+}
+
+// samples what's to be shown, working out the rate and time left from how the progress has moved since last time
+static int _ui_on_sample(void *data) {
+	unsigned updates = __atomic_load_n(&_uiState.updates, __ATOMIC_ACQUIRE);
+	const char *status = __atomic_load_n(&_uiState.status, __ATOMIC_ACQUIRE);
+	uint64_t done = __atomic_load_n(&_uiState.done, __ATOMIC_RELAXED);
+	uint64_t total = __atomic_load_n(&_uiState.total, __ATOMIC_RELAXED);
+	unsigned long now = getTime();
+
+	if(status!=_uiView.status || done<_uiView.done){
+		//something else is under way, so its rate starts over
+		_uiView.rate = 0;
+	}else if(now>_uiView.time){
+		double rate = (done-_uiView.done)*1000.0/(now-_uiView.time);
+		_uiView.rate = _uiView.rate?_uiView.rate*0.75+rate*0.25:rate;
+	}
+	_uiView.status = status;
+	_uiView.done = done;
+	_uiView.time = now;
+
+	//each thread moves the two separately, so they can briefly disagree
+	done = MIN(done, total);
+
+	char text[sizeof(_uiView.text)];
+	if(_uiView.rate>0 && total>=UI_RATE_MINIMUM && done<total){
+		char remaining[32];
+		_ui_format_remaining(remaining, sizeof(remaining), (total-done)/_uiView.rate);
+		snprintf(text, sizeof(text), "%s %.1f MB/s, %s", status?status:"", _uiView.rate/(1024*1024), remaining);
+	}else{
+		snprintf(text, sizeof(text), "%s", status?status:"");
+	}
+
+	if(strcmp(text, _uiView.text)){
+		strcpy(_uiView.text, text);
+		uiLabelSetText(_ui_label, text);
+	}
+
+	int progress = total?(int)(done*100/total):0;
+	if(progress!=_uiView.progress){
+		_uiView.progress = progress;
+		uiProgressBarSetValue(_ui_progress, progress);
+	}
+
+	//show the window the first time it is given information
+	if(!_ui_window_visible && updates!=_uiView.hidden){
+		_ui_window_visible = true;
+		uiControlShow(uiControl(_ui_window));
+	}
+
+	return 1;
+}
+
 static void *_ui_main(void *arg) {
 	uiInitOptions options;
 	memset(&options, 0, sizeof(uiInitOptions));
@@ -155,6 +869,12 @@ static void *_ui_main(void *arg) {
 	spacer = uiNewVerticalBox();
 	uiBoxAppend(rows, uiControl(spacer), true);
 
+	_uiView = (_Ui_view){
+		.hidden = __atomic_load_n(&_uiState.updates, __ATOMIC_ACQUIRE),
+		.progress = -1
+	};
+	uiTimer(UI_SAMPLE_INTERVAL, _ui_on_sample, NULL);
+
 	#ifdef _WIN32
 		ReleaseSemaphore(_ui_loaded, 1, NULL);
 	#else
@@ -173,29 +893,6 @@ DWORD WINAPI _ui_main_win32(LPVOID lpParam) {
 }
 #endif
 
-typedef struct {
-	const char *status;
-	int progress;
-} _Ui_update;
-
-static void _ui_on_update(void *arg){
-	_Ui_update *update = arg;
-
-	if(update->status!=NULL){
-		uiLabelSetText(_ui_label, update->status);
-	}
-	if(update->progress>=0){
-		uiProgressBarSetValue(_ui_progress, update->progress);
-	}
-	free(update);
-
-	//show the window the first time it is given information
-	if(!_ui_window_visible){
-		_ui_window_visible = true;
-		uiControlShow(uiControl(_ui_window));
-	}
-}
-
 static void _ui_on_error(void *arg){
 	const char *message = arg;
 
@@ -209,6 +906,8 @@ static void _ui_on_error(void *arg){
 }
 
 static void _ui_on_hide(void *arg){
+	_uiView.hidden = __atomic_load_n(&_uiState.updates, __ATOMIC_ACQUIRE);
+
 	if(_ui_window_visible){
 		_ui_window_visible = false;
 		uiControlHide(uiControl(_ui_window));
@@ -221,7 +920,6 @@ void ui_init() {
 	_ui_window_visible = false; //reset this before it belongs to the thread
 
 	#ifdef _WIN32
-		_ui_mutex = CreateMutex(NULL, FALSE, NULL);
 		_ui_loaded = CreateSemaphore(NULL, 0, 1, NULL);
 
 		ui_thread = CreateThread(NULL, 0, _ui_main_win32, NULL, 0, NULL);
@@ -233,7 +931,6 @@ void ui_init() {
 		WaitForSingleObject(_ui_loaded, INFINITE);
 
 	#else
-		pthread_mutex_init(&_ui_mutex, NULL);
 		sem_init(&_ui_loaded, 0, 0);
 
 		if(pthread_create(&ui_thread, NULL, _ui_main, NULL)) {
@@ -253,50 +950,43 @@ void ui_hide() {
 	uiQueueMain(_ui_on_hide, NULL);
 }
 
+// `status` must outlive the window, as with a string literal
 void ui_status(const char *status) {
-	if(!ui_enabled) return;
+	__atomic_store_n(&_uiState.status, status, __ATOMIC_RELEASE);
+	__atomic_fetch_add(&_uiState.updates, 1, __ATOMIC_RELEASE);
+}
 
-	_Ui_update *update = malloc(sizeof(*update));
-	update->status = status;
-	update->progress = -1;
+void install_share_progress(uint64_t done, uint64_t total);
 
-	uiQueueMain(_ui_on_update, update);
-}
+// reports `share` having `done` of `total` (bytes, or whatever's to hand), replacing what it reported before
+// a share reporting 0 of 0 drops out of what's shown, as each should once finished with
+void ui_share_progress(Ui_share *share, uint64_t done, uint64_t total) {
+	if(done==share->done && total==share->total) return;
 
-void ui_progress(int progress) {
-	if(!ui_enabled) return;
+	__atomic_fetch_add(&_uiState.total, total-share->total, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&_uiState.done, done-share->done, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&_uiState.updates, 1, __ATOMIC_RELEASE);
+
+	_uiThreadSum.total += total-share->total;
+	_uiThreadSum.done += done-share->done;
 
-	_Ui_update *update = malloc(sizeof(*update));
-	update->status = NULL;
-	update->progress = progress;
+	share->done = done;
+	share->total = total;
+
+	install_share_progress(_uiThreadSum.done, _uiThreadSum.total);
+}
 
-	uiQueueMain(_ui_on_update, update);
+// reports this thread having `done` of `total`, replacing what it reported before, as for each stage of an install
+void ui_progress(uint64_t done, uint64_t total) {
+	ui_share_progress(&_uiThreadShare, done, total);
 }
 
 void ui_cancel() {
-	#ifdef _WIN32
-		WaitForSingleObject(_ui_mutex, INFINITE);
-			_ui_cancelled = true;
-		ReleaseMutex(_ui_mutex);
-	#else
-		pthread_mutex_lock(&_ui_mutex);
-			_ui_cancelled = true;
-		pthread_mutex_unlock(&_ui_mutex);
-	#endif
+	__atomic_store_n(&_uiState.cancelled, true, __ATOMIC_RELAXED);
 }
 
 bool ui_is_cancelled() {
-	bool result;
-	#ifdef _WIN32
-		WaitForSingleObject(_ui_mutex, INFINITE);
-			result = _ui_cancelled;
-		ReleaseMutex(_ui_mutex);
-	#else
-		pthread_mutex_lock(&_ui_mutex);
-			result = _ui_cancelled;
-		pthread_mutex_unlock(&_ui_mutex);
-	#endif
-	return result;
+	return __atomic_load_n(&_uiState.cancelled, __ATOMIC_RELAXED);
 }
 
 void ui_error(const char *message) {
@@ -326,87 +1016,66 @@ void print_help(const char *name){
 	printf("\n");
 	printf("  Options:\n");
 	printf("    -d, --downloadOnly   Download any required Electron updates and then exit\n");
+	printf("                         (for any number of paths, or @files listing them)\n");
 	printf("    -n, --noDownload     Do NOT download if required Electron is not available\n");
 	printf("    -s, --silent         Do not display any user feedback while downloading\n");
 	printf("\n");
 	printf("    Any other options will be passed directly to Electron (if it is executed)\n");
 	printf("\n");
 	printf("  Commands:\n");
+	printf("    --daemon             Keep the Electron versions of known projects installed\n");
+	printf("                         ahead of their launch, checking every\n");
+	printf("                         ELECTRON_SHARED_DAEMON_INTERVAL seconds (default 3600)\n");
+	printf("    --gc                 Remove Electron versions not used recently (see below)\n");
 	printf("    -h, --help           Display this help and exit\n");
 	printf("    -l, --list           Print the currently downloaded Electron versions\n");
 	printf("    -v, --version        Output version information and exit\n");
+	printf("\n");
+	printf("  Downloaded Electron versions are removed (least recently used first) when\n");
+	printf("  ELECTRON_SHARED_MAX_SIZE (in MB) or ELECTRON_SHARED_MAX_COUNT is exceeded,\n");
+	printf("  or with --gc, but never within ELECTRON_SHARED_KEEP_DAYS (default 30) of use\n");
+	printf("\n");
+	printf("  Releases come from GitHub, or from each of ELECTRON_SHARED_MIRRORS in turn\n");
+	printf("  (base urls, file:// included, or \"github\"). From each base the release list\n");
+	printf("  is read at ELECTRON_SHARED_MIRROR_CATALOG (default releases.json) and archives\n");
+	printf("  at ELECTRON_SHARED_MIRROR_ASSET (default {version}/{file}, also with {tag})\n");
+	printf("  Archives are checked against the SHASUMS256.txt published alongside them,\n");
+	printf("  and extracted with a built-in inflater unless ELECTRON_SHARED_INFLATE is miniz\n");
+	printf("  With ELECTRON_SHARED_DOWNLOAD_TO_MEMORY at 1, archives are held in memory\n");
+	printf("  rather than written to disk (although an interrupted download then starts over)\n");
+	printf("\n");
+	printf("  With several paths, -d reads the release list once for them all, downloads\n");
+	printf("  the fewest versions that satisfy every one, and up to\n");
+	printf("  ELECTRON_SHARED_INSTALL_PARALLEL (default 3) of those at once\n");
+	printf("\n");
+	printf("  The daemon looks after every project launched before, and those listed in\n");
+	printf("  ELECTRON_SHARED_APPS (separated as in PATH), installing at low priority\n");
+	printf("\n");
+	printf("  Settings may also be given as NAME = value lines (without the ELECTRON_SHARED_\n");
+	printf("  prefix) in a \"config\" file in the cache folder\n");
 }
 
 void print_version(){
 	printf(PROGRAM_NAME " " PROGRAM_VERSION "\n");
 }
 
-void print_downloads(){
-	char path[MAX_PATH+8];
-	get_user_cache_folder(path, MAX_PATH, PROGRAM_NAME);
-	strcat(path, "runtime" PATH_SEPARATOR);
-
-	int count = 0;
-
-	#ifdef _WIN32
-		mkdir(path);
-
-		WIN32_FIND_DATA findData;
-
-		char *searchpath = malloc(strlen(path)+2);
-		strcpy(searchpath, path);
-		strcat(searchpath, "*"); //put a wildcard star on the end
-		HANDLE search = FindFirstFile(searchpath, &findData);
-			if(search==INVALID_HANDLE_VALUE && GetLastError()!=ERROR_FILE_NOT_FOUND){
-				fprintf(stderr, "Unable to access path: %s\n", path);
-				return;
-			}
-
-			printf("Currently downloaded Electron runtimes (%s):\n", path);
-
-			if(search!=INVALID_HANDLE_VALUE){
-				do{
-					if(findData.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY && findData.cFileName[0]!='.'){
-						count++;
-						printf("  %s\n", findData.cFileName);
-					}
-				}while(FindNextFile(search, &findData));
-			}
-		FindClose(search);
-		free(searchpath);
-
-	#else
-		mkdir(path, 0700);
-
-		DIR *dir = opendir(path);
-			if(!dir){
-				fprintf(stderr, "Unable to access path: %s\n", path);
-				return;
-			}
-
-			printf("Currently downloaded Electron runtimes (%s):\n", path);
-
-			struct dirent *entry;
-			while(entry = readdir(dir)){
-				if(entry->d_type==DT_DIR && entry->d_name[0]!='.'){
-					count++;
-					printf("  %s\n", entry->d_name);
-				}
-			}
-		closedir(dir);
-	#endif
+int json_init_length(jsmn_parser *jsonParser, jsmntok_t *json[], const char *data, size_t dataLength);
+void json_next(jsmntok_t json[], int jsonLength, int *position);
+int json_query(jsmntok_t json[], int jsonLength, const char *data, int parent, const char *path, jsmntype_t type);
+int json_query_key(jsmntok_t json[], int jsonLength, const char *data, int parent, const char *name, jsmntype_t type);
 
-	if(!count){
-		printf("  none found\n");
-	}
-}
+// the contents of a file, either read into memory or viewed in place within an archive
+typedef struct {
+	const char *data;
+	size_t size;
+	char *buffer;           //our own copy, if one was needed
+	struct Asar *archive;   //the archive viewed into, if any
+} File_view;
 
-int json_init(jsmn_parser *jsonParser, jsmntok_t *json[], char *data);
-bool json_find(jsmntok_t json[], int jsonLength, char *data, int parent, int *_position, const char *name, jsmntype_t type);
-void json_next(jsmntok_t json[], int jsonLength, int *position);
+void file_view_free(File_view *file);
 
-int read_file_fs(const char *directory, const char *filename, char **buffer) {
-	*buffer = NULL;
+int read_file_fs(const char *directory, const char *filename, File_view *view) {
+	memset(view, 0, sizeof(*view));
 
 	char *filePath = malloc(strlen(directory)+1+strlen(filename)+1);
 	sprintf(filePath, "%s" PATH_SEPARATOR "%s", directory, filename);
@@ -425,493 +1094,7350 @@ int read_file_fs(const char *directory, const char *filename, char **buffer) {
 	size = ftell(file);
 	fseek(file, 0, SEEK_SET);
 
-	*buffer = malloc(size+1);
-	if(!*buffer){
+	view->buffer = malloc(size+1);
+	if(!view->buffer){
 		fprintf(stderr, "Out of memory reading \"%s\" from \"%s\"\n", filename, directory);
 		fclose(file);
 		free(filePath);
 		return errno?errno:-1;
 	}
 
-	read = fread(*buffer, 1, size, file);
-	(*buffer)[read] = '\0';
+	//text mode may read back less than the full size
+	read = fread(view->buffer, 1, size, file);
+	view->buffer[read] = '\0';
 	fclose(file);
 
-	if(read<size){
-		free(*buffer);
-		*buffer = 0;
-	}
+	view->data = view->buffer;
+	view->size = read;
 
 	free(filePath);
 
 	return 0;
 }
 
-#define ASAR_ALIGN(x) (((x)+7)/8*8)
 
-// only reads toplevel files for now, cos that's all we need
-int read_file_asar(const char *archive, const char *filename, char **buffer) {
-	*buffer = NULL;
+static bool _make_directory(const char *path) {
+	#ifdef _WIN32
+		return !mkdir(path)||errno==EEXIST;
+	#else
+		return !mkdir(path, 0700)||errno==EEXIST;
+	#endif
+}
 
-	FILE *file;
-	file = fopen(archive, "rb");
-	if(!file){
-		return errno?errno:-1;
+bool make_path(const char *path) {
+	//the parents are usually there already (as when extracting file after file into the same directories), so only work through them if they aren't
+	if(_make_directory(path)) return true;
+	if(errno!=ENOENT) return false;
+
+	char *directory = strdup(path);
+
+	for(char *c=directory+1; *c; c++){
+		if(*c=='/'||*c=='\\'){
+			char separator = *c;
+			*c = '\0';
+			#ifdef _WIN32
+				mkdir(directory);
+			#else
+				mkdir(directory, 0700);
+			#endif
+			*c = separator;
+		}
 	}
 
-	int error = -1;
+	bool success = _make_directory(directory);
 
-	char *header = NULL;
-	jsmn_parser jsonParser;
-	jsmntok_t *json = NULL;
+	free(directory);
 
-	do{
-		uint32_t headerSize = 0;
+	return success;
+}
 
-		if(fseek(file, 4, SEEK_CUR)) break;
-		if(!fread(&headerSize, 4, 1, file)) break;
+// renames `from` to `to`, replacing anything already there in a single step
+bool rename_replace(const char *from, const char *to) {
+	#ifdef _WIN32
+		return MoveFileEx(from, to, MOVEFILE_REPLACE_EXISTING);
+	#else
+		return !rename(from, to);
+	#endif
+}
 
-		uint32_t headerStringSize = 0;
-		if(fseek(file, 4, SEEK_CUR)) break;
-		if(!fread(&headerStringSize, 4, 1, file)) break;
+#define FILE_WRITE_BUFFER (256*1024) //for files written a little at a time, rather than stdio's few KB
+
+// reserves `size` bytes of disk for `file` up front, without changing its length, so it can be laid out in one piece (where the system allows)
+void file_reserve(FILE *file, uint64_t size) {
+	if(!size) return;
+
+	#if defined(_WIN32)
+		FILE_ALLOCATION_INFO allocation = {.AllocationSize.QuadPart = size};
+		SetFileInformationByHandle((HANDLE)_get_osfhandle(_fileno(file)), FileAllocationInfo, &allocation, sizeof(allocation));
+	#elif defined(__linux__) && defined(__LP64__)
+		//not posix_fallocate(), which writes zeros instead on filesystems that can't allocate (and called directly, as 32 bit systems split the offsets)
+		syscall(SYS_fallocate, fileno(file), FALLOC_FL_KEEP_SIZE, (off_t)0, (off_t)size);
+	#elif defined(__APPLE__)
+		fstore_t store = {.fst_flags = F_ALLOCATEALL, .fst_posmode = F_PEOFPOSMODE, .fst_length = size};
+		fcntl(fileno(file), F_PREALLOCATE, &store);
+	#endif
+}
 
-		header = malloc(headerStringSize+1);
-		if(!fread(header, headerStringSize, 1, file)) break;
-		header[headerSize] = '\0';
+#ifndef _WIN32
+	// flushes each file and directory within `path` (and `path` itself) to disk
+	static void _sync_tree(const char *path) {
+		int file = open(path, O_RDONLY|O_NOFOLLOW|O_CLOEXEC);
+		if(file<0) return; //including symlinks, which have nothing of their own to flush
+
+		struct stat info;
+		DIR *dir = !fstat(file, &info) && S_ISDIR(info.st_mode)?fdopendir(file):NULL;
+		if(!dir){
+			fsync(file);
+			close(file);
+			return;
+		}
 
-		// if(fseek(file, ASAR_ALIGN(16+headerStringSize), SEEK_SET)) break; //apparently these AREN'T aligned?
+		struct dirent *entry;
+		while(entry = readdir(dir)){
+			if(!strcmp(entry->d_name, ".")||!strcmp(entry->d_name, "..")) continue;
 
+			char *child = malloc(strlen(path)+1+strlen(entry->d_name)+1);
+			sprintf(child, "%s" PATH_SEPARATOR "%s", path, entry->d_name);
+			_sync_tree(child);
+			free(child);
+		}
 
-		int parsed = json_init(&jsonParser, &json, header);
-		if(!json) break;
+		//after what's within, so nothing it lists is left unwritten
+		fsync(dirfd(dir));
+		closedir(dir);
+	}
+#endif
 
-		if(parsed<1||json[0].type!=JSMN_OBJECT){
-			fprintf(stderr, "Error parsing ASAR header JSON\n");
-			break;
+// flushes everything written within `path` to disk, once for a whole install rather than file by file as it's written
+void sync_filesystem(const char *path) {
+	#ifndef _WIN32
+		//just what's within, as syncfs() or sync() would flush everything else written to the filesystem too
+		_sync_tree(path);
+
+		#ifdef F_FULLFSYNC
+			//which on macOS only hands it to the drive, so have the drive write out its cache too, once for them all
+			int directory = open(path, O_RDONLY|O_CLOEXEC);
+			if(directory>=0){
+				fcntl(directory, F_FULLFSYNC);
+				close(directory);
+			}
+		#endif
+	#endif
+	//Windows has no equivalent short of flushing the whole volume, which needs administrator rights
+}
+
+// flushes the entries of directory `path` to disk (but not what they hold), so something just renamed into it stays there
+void sync_directory(const char *path) {
+	#ifndef _WIN32
+		int directory = open(path, O_RDONLY|O_CLOEXEC);
+		if(directory>=0){
+			#ifdef F_FULLFSYNC
+				fcntl(directory, F_FULLFSYNC);
+			#else
+				fsync(directory);
+			#endif
+			close(directory);
 		}
+	#endif
+}
 
-		int filesPosition = 1;
-		if(!json_find(json, parsed, header, 0, &filesPosition, "files", JSMN_OBJECT)) break;
+bool remove_directory(const char *path) {
+	bool success = true;
 
-		int filePosition = filesPosition+1;
-		if(!json_find(json, parsed, header, filesPosition, &filePosition, filename, JSMN_OBJECT)) break;
+	#ifdef _WIN32
+		WIN32_FIND_DATA findData;
 
-		int sizePosition = filePosition+1;
-		int offsetPosition = filePosition+1;
+		char *searchpath = malloc(strlen(path)+2+1);
+		sprintf(searchpath, "%s" PATH_SEPARATOR "*", path);
+		HANDLE search = FindFirstFile(searchpath, &findData);
+		free(searchpath);
 
-		if(
-			!json_find(json, parsed, header, filePosition, &sizePosition, "size", JSMN_STRING)||
-			!json_find(json, parsed, header, filePosition, &offsetPosition, "offset", JSMN_STRING)
-		) break;
+		if(search!=INVALID_HANDLE_VALUE){
+			do{
+				if(!strcmp(findData.cFileName, ".")||!strcmp(findData.cFileName, "..")) continue;
 
-		unsigned long int size = strtoul(&header[json[sizePosition].start], NULL, 10);
-		unsigned long int offset = strtoul(&header[json[offsetPosition].start], NULL, 10);
+				char *child = malloc(strlen(path)+1+strlen(findData.cFileName)+1);
+				sprintf(child, "%s" PATH_SEPARATOR "%s", path, findData.cFileName);
 
-		*buffer = malloc(size+1);
-		if(!*buffer){
-			fprintf(stderr, "Out of memory reading \"%s\" from \"%s\" ASAR archive\n", filename, archive);
-			break;
-		}
+				if(findData.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY){
+					success = remove_directory(child) && success;
+				}else{
+					SetFileAttributes(child, FILE_ATTRIBUTE_NORMAL);
+					success = DeleteFile(child) && success;
+				}
 
-		if(
-			fseek(file, offset, SEEK_CUR)||
-			fread(*buffer, 1, size, file)!=size
-		){
-			free(*buffer);
-			*buffer = NULL;
-			break;
+				free(child);
+			}while(FindNextFile(search, &findData));
+
+			FindClose(search);
 		}
-		(*buffer)[size] = '\0';
 
-		error = 0;
+		return RemoveDirectory(path) && success;
 
-	}while(false);
+	#else
+		DIR *dir = opendir(path);
+		if(dir){
+			struct dirent *entry;
+			while(entry = readdir(dir)){
+				if(!strcmp(entry->d_name, ".")||!strcmp(entry->d_name, "..")) continue;
 
-	free(header);
-	free(json);
+				char *child = malloc(strlen(path)+1+strlen(entry->d_name)+1);
+				sprintf(child, "%s" PATH_SEPARATOR "%s", path, entry->d_name);
 
-	fclose(file);
+				if(entry->d_type==DT_DIR){
+					success = remove_directory(child) && success;
+				}else{
+					success = !unlink(child) && success;
+				}
 
-	return error;
+				free(child);
+			}
+			closedir(dir);
+		}
+
+		return !rmdir(path) && success;
+	#endif
 }
 
-int read_file(const char *directory, const char *filename, char **buffer) {
-	int error = read_file_fs(directory, filename, buffer);
-	if(error==ENOTDIR){
-		error = read_file_asar(directory, filename, buffer);
-	}
+// calls `on_entry` for each entry within directory `path`
+bool directory_visit(const char *path, void (*on_entry)(const char *path, const char *name, bool directory, void *data), void *data) {
+	#ifdef _WIN32
+		WIN32_FIND_DATA findData;
 
-	return error;
-}
+		char *searchpath = malloc(strlen(path)+2+1);
+		sprintf(searchpath, "%s" PATH_SEPARATOR "*", path);
+		HANDLE search = FindFirstFile(searchpath, &findData);
+		free(searchpath);
 
+		if(search==INVALID_HANDLE_VALUE) return false;
 
-bool extract_files(const char *archive, const char *path) {
-	ui_status("Extracting...");
+		do{
+			if(!strcmp(findData.cFileName, ".")||!strcmp(findData.cFileName, "..")) continue;
 
-	bool success = zip_extract(archive, path, NULL, NULL) == 0;
+			on_entry(path, findData.cFileName, findData.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY, data);
+		}while(FindNextFile(search, &findData));
 
-	return success;
-}
+		FindClose(search);
 
-typedef struct {
-	char *buffer;
-	size_t length;
-	size_t size;
-} _Curl_buffer;
+	#else
+		DIR *dir = opendir(path);
+		if(!dir) return false;
 
-static size_t _on_curl_write_memory(const char *ptr, size_t size, size_t nmemb, void *userdata) {
-	_Curl_buffer *buffer = userdata;
+		struct dirent *entry;
+		while(entry = readdir(dir)){
+			if(!strcmp(entry->d_name, ".")||!strcmp(entry->d_name, "..")) continue;
 
-	size_t chunkSize = size*nmemb;
+			on_entry(path, entry->d_name, entry->d_type==DT_DIR, data);
+		}
+		closedir(dir);
+	#endif
 
-	if(buffer->length+chunkSize+1>=buffer->size){
-		buffer->size = buffer->size+chunkSize+1+(64*1024);
+	return true;
+}
 
-		char *newBuffer = realloc(buffer->buffer, buffer->size);
-		if(!newBuffer){
-			fprintf(stderr, "Out of memory making web request\n");
-			return 0;
+// an open file, locked against other processes for as long as it's held
+#ifdef _WIN32
+	typedef HANDLE File_lock;
+#else
+	typedef int File_lock;
+#endif
+
+// opens (creating if needed) and locks `path`, shared or `exclusive`ly, waiting for any conflicting lock to be released if `wait` is set
+bool file_lock(const char *path, bool exclusive, bool wait, File_lock *lock) {
+	#ifdef _WIN32
+		HANDLE handle = CreateFile(path, GENERIC_READ|GENERIC_WRITE, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if(handle==INVALID_HANDLE_VALUE) return false;
+
+		OVERLAPPED overlapped = {0};
+		if(!LockFileEx(handle, (exclusive?LOCKFILE_EXCLUSIVE_LOCK:0)|(wait?0:LOCKFILE_FAIL_IMMEDIATELY), 0, 1, 0, &overlapped)){
+			CloseHandle(handle);
+			return false;
 		}
 
-		buffer->buffer = newBuffer;
-	}
+		*lock = handle;
 
-	memcpy(&buffer->buffer[buffer->length], ptr, chunkSize);
+	#else
+		int file = open(path, O_RDWR|O_CREAT, 0600);
+		if(file<0) return false;
 
-	buffer->length += chunkSize;
-	buffer->buffer[buffer->length] = '\0';
+		if(flock(file, (exclusive?LOCK_EX:LOCK_SH)|(wait?0:LOCK_NB))){
+			close(file);
+			return false;
+		}
 
-	return chunkSize;
-}
+		*lock = file;
+	#endif
 
-static size_t _on_curl_write_file(const char *ptr, size_t size, size_t nmemb, void *userdata) {
-	FILE *file = userdata;
+	return true;
+}
 
-	return fwrite(ptr, size, nmemb, file);
+void file_unlock(File_lock *lock) {
+	#ifdef _WIN32
+		CloseHandle(*lock);
+	#else
+		close(*lock);
+	#endif
 }
 
-static int _on_curl_progress(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow) {
-	static unsigned long lastUiTime = 0;
+typedef struct {
+	uint8_t *data;
+	uint64_t size;
+	#ifdef _WIN32
+		HANDLE file;
+		HANDLE mapping;
+	#endif
+} Mapped_file;
 
-	unsigned long now = getTime();
+bool map_file(const char *filename, Mapped_file *mapped) {
+	mapped->data = NULL;
+	mapped->size = 0;
 
-	if(now-lastUiTime>1000/30){
-		lastUiTime = now;
+	#ifdef _WIN32
+		mapped->file = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if(mapped->file==INVALID_HANDLE_VALUE) return false;
 
-		if(dltotal>0){
-			ui_progress((int)((dlnow*100)/dltotal));
-		}else{
-			ui_progress(0);
+		LARGE_INTEGER size;
+		if(!GetFileSizeEx(mapped->file, &size) || !size.QuadPart){
+			CloseHandle(mapped->file);
+			return false;
 		}
-	}
+		mapped->size = size.QuadPart;
 
-	if(ui_is_cancelled()) return 1;
+		mapped->mapping = CreateFileMapping(mapped->file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if(!mapped->mapping){
+			CloseHandle(mapped->file);
+			return false;
+		}
 
-	return 0;
-}
+		mapped->data = MapViewOfFile(mapped->mapping, FILE_MAP_READ, 0, 0, 0);
+		if(!mapped->data){
+			CloseHandle(mapped->mapping);
+			CloseHandle(mapped->file);
+			return false;
+		}
 
-void fetch(char **buffer, const char *url) {
-	ui_status("Fetching update list...");
+	#else
+		int file = open(filename, O_RDONLY);
+		if(file<0) return false;
 
-	*buffer = 0;
+		struct stat info;
+		if(fstat(file, &info) || !info.st_size){
+			close(file);
+			return false;
+		}
+		mapped->size = info.st_size;
 
-	CURL *curl;
-	CURLcode res;
- 
-	curl = curl_easy_init();
-	if(!curl){
-		on_error("Error initialising libcurl");
-		return;
-	}
+		void *data = mmap(NULL, mapped->size, PROT_READ, MAP_SHARED, file, 0);
+		close(file);
 
-	_Curl_buffer curlBuffer = {
-		.buffer = malloc(4096),
-		.length = 0,
-		.size = 4096
-	};
+		if(data==MAP_FAILED) return false;
 
-	curlBuffer.buffer[0] = '\0';
+		mapped->data = data;
+	#endif
 
-	curl_easy_setopt(curl, CURLOPT_URL, url);
-	curl_easy_setopt(curl, CURLOPT_USERAGENT, PROGRAM_NAME "/" PROGRAM_VERSION);
-	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, true);
-	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _on_curl_write_memory);
-	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &curlBuffer);
-	curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, _on_curl_progress);
-	curl_easy_setopt(curl, CURLOPT_NOPROGRESS, false);
+	return true;
+}
 
-	CURLcode response = curl_easy_perform(curl);
+// maps `size` bytes of zeroed, writable memory, backed by nothing but the page file (or swap), for unmap_file() to release
+bool map_anonymous(uint64_t size, Mapped_file *mapped) {
+	mapped->data = NULL;
+	mapped->size = size;
 
-	if(response!=CURLE_OK){
-		if(response!=CURLE_ABORTED_BY_CALLBACK){
-			switch(response){
-				case CURLE_COULDNT_CONNECT:
-				case CURLE_COULDNT_RESOLVE_HOST:
-					on_error("Could not connect (%i)\nPlease ensure you have access to the internet", response);
-				break;
-				default:
-					on_error("Error retrieving %s\n%s", url, curl_easy_strerror(response));
-			}
+	if(!size || size>SIZE_MAX) return false;
+
+	#ifdef _WIN32
+		mapped->file = INVALID_HANDLE_VALUE;
+		mapped->mapping = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, size>>32, (DWORD)size, NULL);
+		if(!mapped->mapping) return false;
+
+		mapped->data = MapViewOfFile(mapped->mapping, FILE_MAP_WRITE, 0, 0, 0);
+		if(!mapped->data){
+			CloseHandle(mapped->mapping);
+			return false;
 		}
+	#else
+		void *data = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+		if(data==MAP_FAILED) return false;
+		mapped->data = data;
+	#endif
 
-		free(curlBuffer.buffer);
-		curlBuffer.buffer = NULL;
-	}
+	return true;
+}
 
-	*buffer = curlBuffer.buffer;
+void unmap_file(Mapped_file *mapped) {
+	if(!mapped->data) return;
 
-	curl_easy_cleanup(curl);
+	#ifdef _WIN32
+		UnmapViewOfFile(mapped->data);
+		CloseHandle(mapped->mapping);
+		if(mapped->file!=INVALID_HANDLE_VALUE){
+			CloseHandle(mapped->file);
+		}
+	#else
+		munmap(mapped->data, mapped->size);
+	#endif
+
+	mapped->data = NULL;
 }
 
-bool download(const char *url, const char *filename) {
-	ui_status("Downloading...");
+// little endian values, as used by archives
+static uint16_t _read16(const uint8_t *data) { return data[0] | data[1]<<8; }
+static uint32_t _read32(const uint8_t *data) { return _read16(data) | (uint32_t)_read16(data+2)<<16; }
+static uint64_t _read64(const uint8_t *data) { return _read32(data) | (uint64_t)_read32(data+4)<<32; }
 
-	CURL *curl;
-	CURLcode res;
- 
-	curl = curl_easy_init();
-	if(!curl){
-		on_error("Error initialising libcurl");
+// an ASAR archive, mapped into memory with an index of every file it holds, by full path (such as "node_modules/x/package.json")
+
+typedef struct {
+	uint64_t offset;     //from the start of the archive
+	uint64_t size;
+	uint64_t hash;
+	uint32_t path;       //where the path is in the archive's path buffer
+	uint32_t pathLength;
+	bool unpacked;       //stored outside the archive, under "<archive>.unpacked"
+} Asar_entry;
+
+typedef struct Asar {
+	Mapped_file mapped;
+	Asar_entry *entries;
+	uint32_t entryCount;
+	uint32_t entryCapacity;
+	char *paths;
+	size_t pathsLength;
+	size_t pathsCapacity;
+	uint32_t *slots;     //hash table of entry indices (plus one, so zero is empty)
+	uint32_t slotMask;
+} Asar;
+
+static bool _asar_add(Asar *asar, const char *path, size_t pathLength, uint64_t offset, uint64_t size, bool unpacked) {
+	if(asar->entryCount>=asar->entryCapacity){
+		uint32_t capacity = asar->entryCapacity?asar->entryCapacity*2:64;
+		Asar_entry *entries = realloc(asar->entries, capacity*sizeof(Asar_entry));
+		if(!entries) return false;
+
+		asar->entries = entries;
+		asar->entryCapacity = capacity;
+	}
+
+	if(asar->pathsLength+pathLength+1>asar->pathsCapacity || asar->pathsLength+pathLength+1>UINT32_MAX){
+		size_t capacity = MAX(asar->pathsCapacity*2, asar->pathsLength+pathLength+1+4096);
+		char *paths = realloc(asar->paths, capacity);
+		if(!paths || capacity>UINT32_MAX) return false;
+
+		asar->paths = paths;
+		asar->pathsCapacity = capacity;
+	}
+
+	Asar_entry *entry = &asar->entries[asar->entryCount++];
+	entry->offset = offset;
+	entry->size = size;
+	entry->hash = hash_bytes(path, pathLength);
+	entry->path = asar->pathsLength;
+	entry->pathLength = pathLength;
+	entry->unpacked = unpacked;
+
+	memcpy(asar->paths+asar->pathsLength, path, pathLength);
+	asar->paths[asar->pathsLength+pathLength] = '\0';
+	asar->pathsLength += pathLength+1;
+
+	return true;
+}
+
+// adds everything in the "files" object at `files` to the index, with their names following `path`
+static bool _asar_index(Asar *asar, jsmntok_t json[], int jsonLength, const char *header, uint64_t base, int files, char **path, size_t *pathSize, size_t pathLength) {
+	int end = files;
+	json_next(json, jsonLength, &end);
+
+	for(int key=files+1; key+1<end; ){
+		int value = key+1;
+
+		size_t nameLength = json[key].end-json[key].start;
+		size_t length = pathLength+(pathLength?1:0)+nameLength;
+
+		if(length+1>*pathSize){
+			size_t size = MAX(*pathSize*2, length+1);
+			char *newPath = realloc(*path, size);
+			if(!newPath) return false;
+
+			*path = newPath;
+			*pathSize = size;
+		}
+
+		if(pathLength) (*path)[pathLength] = '/';
+		memcpy(*path+length-nameLength, &header[json[key].start], nameLength);
+
+		if(json[value].type==JSMN_OBJECT){
+			int children = json_query_key(json, jsonLength, header, value, "files", JSMN_OBJECT);
+
+			if(children>=0){
+				if(!_asar_index(asar, json, jsonLength, header, base, children, path, pathSize, length)) return false;
+
+			}else{
+				int offset = json_query_key(json, jsonLength, header, value, "offset", JSMN_STRING);
+				int size = json_query_key(json, jsonLength, header, value, "size", JSMN_STRING);
+				int unpacked = json_query_key(json, jsonLength, header, value, "unpacked", JSMN_STRING);
+
+				bool isUnpacked = unpacked>=0 && json[unpacked].end-json[unpacked].start==4 && !strncmp(&header[json[unpacked].start], "true", 4);
+
+				//anything else (such as a symlink) isn't a file we can read
+				if(size>=0 && (offset>=0 || isUnpacked)){
+					uint64_t fileOffset = offset>=0?strtoull(&header[json[offset].start], NULL, 10):0;
+					uint64_t fileSize = strtoull(&header[json[size].start], NULL, 10);
+
+					if(!isUnpacked && (fileOffset>asar->mapped.size-base || fileSize>asar->mapped.size-base-fileOffset)){
+						fprintf(stderr, "ASAR archive entry is out of bounds: %.*s\n", (int)length, *path);
+						return false;
+					}
+
+					if(!_asar_add(asar, *path, length, base+fileOffset, fileSize, isUnpacked)) return false;
+				}
+			}
+		}
+
+		key = value;
+		json_next(json, jsonLength, &key);
+	}
+
+	return true;
+}
+
+void asar_close(Asar *asar) {
+	unmap_file(&asar->mapped);
+	free(asar->entries);
+	free(asar->paths);
+	free(asar->slots);
+	memset(asar, 0, sizeof(*asar));
+}
+
+// maps and indexes the archive `filename`
+bool asar_open(Asar *asar, const char *filename) {
+	memset(asar, 0, sizeof(*asar));
+
+	if(!map_file(filename, &asar->mapped)) return false;
+
+	const uint8_t *data = asar->mapped.data;
+	uint64_t archiveSize = asar->mapped.size;
+
+	//a pickle holding the size of the header pickle, which holds the header JSON as a string (lengths are all little endian)
+	if(archiveSize<16 || _read32(data)!=4){
+		asar_close(asar);
 		return false;
 	}
 
-	FILE *file = fopen(filename, "wb");
-	if(!file){
-		on_error("Unable to write to \"%s\"", filename);
+	uint32_t headerSize = _read32(data+4);
+	uint32_t headerStringSize = _read32(data+12);
+
+	if(headerSize<8 || headerSize>archiveSize-8 || headerStringSize>headerSize-8){
+		fprintf(stderr, "Error parsing ASAR header\n");
+		asar_close(asar);
 		return false;
 	}
 
-	curl_easy_setopt(curl, CURLOPT_URL, url);
-	curl_easy_setopt(curl, CURLOPT_USERAGENT, PROGRAM_NAME "/" PROGRAM_VERSION);
-	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, true);
-	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _on_curl_write_file);
-	if(ui_enabled){
-		curl_easy_setopt(curl, CURLOPT_PROGRESSFUNCTION, _on_curl_progress);
+	const char *header = (const char*)data+16;
+	uint64_t base = 8+headerSize; //file offsets count from the end of the header
+
+	jsmn_parser jsonParser;
+	jsmntok_t *json;
+
+	int parsed = json_init_length(&jsonParser, &json, header, headerStringSize);
+
+	if(!json || parsed<1 || json[0].type!=JSMN_OBJECT){
+		fprintf(stderr, "Error parsing ASAR header JSON\n");
+		asar_close(asar);
+		return false;
 	}
-	curl_easy_setopt(curl, CURLOPT_NOPROGRESS, false);
-	curl_easy_setopt(curl, CURLOPT_WRITEDATA, file);
 
-	CURLcode response = curl_easy_perform(curl);
+	int files = json_query_key(json, parsed, header, 0, "files", JSMN_OBJECT);
 
-	bool success = true;
+	char *path = NULL;
+	size_t pathSize = 0;
 
-	if(response!=CURLE_OK){
-		if(response!=CURLE_ABORTED_BY_CALLBACK){
-			on_error("Error downloading \"%s\"\n  %s", url, curl_easy_strerror(response));
+	bool success = files>=0 && _asar_index(asar, json, parsed, header, base, files, &path, &pathSize, 0);
+
+	free(path);
+
+	if(!success){
+		asar_close(asar);
+		return false;
+	}
+
+	//keep the table at most half full
+	uint32_t slotCount = 16;
+	while(slotCount<asar->entryCount*2) slotCount *= 2;
+
+	asar->slots = calloc(slotCount, sizeof(uint32_t));
+	if(!asar->slots){
+		asar_close(asar);
+		return false;
+	}
+	asar->slotMask = slotCount-1;
+
+	for(uint32_t i=0; i<asar->entryCount; i++){
+		uint32_t slot = asar->entries[i].hash&asar->slotMask;
+		while(asar->slots[slot]) slot = (slot+1)&asar->slotMask;
+
+		asar->slots[slot] = i+1;
+	}
+
+	return true;
+}
+
+// returns the entry for the file at `path` (separated by '/'), if there is one
+const Asar_entry *asar_find(const Asar *asar, const char *path) {
+	size_t pathLength = strlen(path);
+	uint64_t hash = hash_bytes(path, pathLength);
+
+	for(uint32_t slot = hash&asar->slotMask; asar->slots[slot]; slot = (slot+1)&asar->slotMask){
+		const Asar_entry *entry = &asar->entries[asar->slots[slot]-1];
+
+		if(entry->hash==hash && entry->pathLength==pathLength && !memcmp(asar->paths+entry->path, path, pathLength)){
+			return entry;
 		}
+	}
 
-		success = false;
+	return NULL;
+}
+
+// reads `filename` from within `archive`, as a view straight into the mapped archive where possible
+int read_file_asar(const char *archive, const char *filename, File_view *view) {
+	memset(view, 0, sizeof(*view));
+
+	Asar *asar = malloc(sizeof(Asar));
+	if(!asar) return ENOMEM;
+
+	errno = 0;
+	if(!asar_open(asar, archive)){
+		free(asar);
+		return errno?errno:-1;
 	}
 
-	curl_easy_cleanup(curl);
-	fclose(file);
+	const Asar_entry *entry = asar_find(asar, filename);
 
-	return success;
+	if(!entry){
+		asar_close(asar);
+		free(asar);
+		return ENOENT;
+	}
+
+	if(entry->unpacked){
+		char *unpackedPath = malloc(strlen(archive)+9+1);
+		sprintf(unpackedPath, "%s.unpacked", archive);
+
+		int error = read_file_fs(unpackedPath, filename, view);
+
+		free(unpackedPath);
+		asar_close(asar);
+		free(asar);
+
+		return error;
+	}
+
+	view->data = (const char*)asar->mapped.data+entry->offset;
+	view->size = entry->size;
+	view->archive = asar;
+
+	return 0;
+}
+
+int read_file(const char *directory, const char *filename, File_view *view) {
+	int error = read_file_fs(directory, filename, view);
+	if(error==ENOTDIR){
+		error = read_file_asar(directory, filename, view);
+	}
+
+	return error;
 }
 
-int json_init(jsmn_parser *jsonParser, jsmntok_t *json[], char *data) {
-	size_t dataLength = strlen(data);
+void file_view_free(File_view *view) {
+	free(view->buffer);
 
-	jsmn_init(jsonParser);
-	int size = jsmn_parse(jsonParser, data, dataLength, NULL, 0);
-	if(size<=0){
-		*json = NULL;
-		return 0;
+	if(view->archive){
+		asar_close(view->archive);
+		free(view->archive);
 	}
 
-	*json = malloc(size*sizeof(jsmntok_t));
-	if(!json){
-		fprintf(stderr, "Out of memory parsing JSON\n");
-		free(*json);
-		*json = NULL;
-		return 0;
+	memset(view, 0, sizeof(*view));
+}
+
+// the size and modification time of a file, as finely as the system gives it, for noticing changes without reading it
+typedef struct {
+	uint64_t size;
+	int64_t time;
+} File_stamp;
+
+bool file_stamp(const char *path, File_stamp *stamp) {
+	#ifdef _WIN32
+		WIN32_FILE_ATTRIBUTE_DATA data;
+		if(!GetFileAttributesEx(path, GetFileExInfoStandard, &data)) return false;
+
+		stamp->size = (uint64_t)data.nFileSizeHigh<<32 | data.nFileSizeLow;
+		stamp->time = (int64_t)data.ftLastWriteTime.dwHighDateTime<<32 | data.ftLastWriteTime.dwLowDateTime;
+
+	#else
+		struct stat info;
+		if(stat(path, &info)) return false;
+
+		stamp->size = info.st_size;
+		#if defined(__APPLE__)
+			stamp->time = (int64_t)info.st_mtimespec.tv_sec*1000000000+info.st_mtimespec.tv_nsec;
+		#else
+			stamp->time = (int64_t)info.st_mtim.tv_sec*1000000000+info.st_mtim.tv_nsec;
+		#endif
+	#endif
+
+	return true;
+}
+
+// versions are compared as packed keys: 16 bits each for the major, minor and patch, then 16 bits that are 0xFFFF for releases, or 0 for prereleases (which thus sort below their release, but tie with each other)
+// requirements are compiled from npm's range syntax into sorted intervals of those keys, so testing a version is a binary search rather than a parse and compare against each part of the range
+
+#define VERSION_PART_MAXIMUM 0xFFFF       //largest major, minor or patch a key holds (larger ones are clamped to it)
+#define VERSION_RELEASE 0xFFFF            //the last 16 bits of the key of a release
+#define VERSION_COMPARATORS_MAXIMUM 32    //most comparators a single set of a range may hold
+
+typedef struct {
+	uint64_t key;
+	const char *prerelease;               //within the string parsed, or NULL for a release
+	size_t prereleaseLength;
+} Version;
+
+typedef struct {
+	uint64_t low;                         //inclusive
+	uint64_t high;                        //inclusive
+} Version_interval;
+
+// the prereleases of a single major.minor.patch allowed by a set of comparators, as npm only lets prereleases match comparators that name one of the same version
+typedef struct {
+	uint64_t key;                         //of the prereleases (so with the last 16 bits 0)
+	char *low;                            //prerelease bounds within that version, or NULL if unbounded
+	bool lowInclusive;
+	char *high;
+	bool highInclusive;
+} Version_prereleases;
+
+typedef struct {
+	Version_interval *intervals;          //releases matched, sorted and without overlaps
+	uint32_t count;
+	Version_prereleases *prereleases;     //prereleases matched, sorted by key
+	uint32_t prereleaseCount;
+} Version_range;
+
+static uint64_t _version_pack(uint64_t major, uint64_t minor, uint64_t patch, bool release) {
+	return MIN(major, VERSION_PART_MAXIMUM)<<48 | MIN(minor, VERSION_PART_MAXIMUM)<<32 | MIN(patch, VERSION_PART_MAXIMUM)<<16 | (release?VERSION_RELEASE:0);
+}
+
+static bool _version_identifier_char(char c) {
+	return c>='0'&&c<='9' || c>='a'&&c<='z' || c>='A'&&c<='Z' || c=='-';
+}
+
+// reads a dot separated list of identifiers (for a prerelease or build), returning its length
+static size_t _version_identifiers(const char *string) {
+	size_t length = 0;
+	while(_version_identifier_char(string[length]) || string[length]=='.' && length>0 && _version_identifier_char(string[length+1])) length++;
+
+	return length;
+}
+
+// checks a prerelease has no numeric identifiers with leading zeroes, which semver forbids
+static bool _version_prerelease_valid(const char *prerelease, size_t length) {
+	for(size_t start=0; start<length;){
+		size_t end = start;
+		bool numeric = true;
+		while(end<length && prerelease[end]!='.'){
+			numeric = numeric && prerelease[end]>='0'&&prerelease[end]<='9';
+			end++;
+		}
+
+		if(numeric && end-start>1 && prerelease[start]=='0') return false;
+
+		start = end+1;
 	}
 
-	jsmn_init(jsonParser);
-	return jsmn_parse(jsonParser, data, dataLength, *json, size);
+	return true;
 }
 
-bool json_find(jsmntok_t json[], int jsonLength, char *data, int parent, int *_position, const char *name, jsmntype_t type) {
-	int position = *_position;
-	int maxByte = json[parent].end;
-	int nameLength = strlen(name);
+// parses a full version ("1.2.3", "v1.2.3-beta.1+build" etc) without allocating, with the prerelease viewed in place
+bool version_parse(const char *string, Version *version) {
+	while(*string=='v'||*string=='=') string++;
 
-	while(position<jsonLength&&json[position].start<maxByte){
-		if(json[position].end-json[position].start==nameLength && !strncmp(name, &data[json[position].start], nameLength)){
-			++position;
+	uint64_t parts[3] = {0};
+	for(unsigned i=0; i<3; i++){
+		if(i>0 && *string++!='.') return false;
+		if(*string<'0'||*string>'9') return false;
 
-			if(json[position].type==type || type==JSMN_STRING && json[position].type==JSMN_PRIMITIVE){
-				*_position = position;
-				return true;
-			}else{
-				return false;
-			}
+		for(; *string>='0'&&*string<='9'; string++){
+			parts[i] = MIN(parts[i]*10+(*string-'0'), VERSION_PART_MAXIMUM);
 		}
+	}
 
-		json_next(json, jsonLength, &position);
+	version->prerelease = NULL;
+	version->prereleaseLength = 0;
+
+	if(*string=='-'){
+		size_t length = _version_identifiers(string+1);
+		if(!length || !_version_prerelease_valid(string+1, length)) return false;
+
+		version->prerelease = string+1;
+		version->prereleaseLength = length;
+		string += 1+length;
 	}
 
-	return false;
+	if(*string=='+'){
+		size_t length = _version_identifiers(string+1);
+		if(!length) return false;
+
+		string += 1+length;
+	}
+
+	if(*string) return false;
+
+	version->key = _version_pack(parts[0], parts[1], parts[2], !version->prerelease);
+
+	return true;
 }
 
-void json_next(jsmntok_t json[], int jsonLength, int *position) {
-	// if(json[*position].start==json[*position].end){
-	// 	(*position)++;
-	// 	return;
-	// }
-	for(int skipTo=json[*position].end; *position<jsonLength&&json[*position].start<=skipTo; (*position)++);
+// compares prereleases as semver does: identifier by identifier, numerically where both are numbers, with numbers before words, and fewer identifiers first
+static int _version_compare_prerelease(const char *a, size_t aLength, const char *b, size_t bLength) {
+	size_t aPosition = 0;
+	size_t bPosition = 0;
+
+	while(aPosition<aLength && bPosition<bLength){
+		size_t aEnd = aPosition;
+		bool aNumeric = true;
+		while(aEnd<aLength && a[aEnd]!='.'){
+			aNumeric = aNumeric && a[aEnd]>='0'&&a[aEnd]<='9';
+			aEnd++;
+		}
+
+		size_t bEnd = bPosition;
+		bool bNumeric = true;
+		while(bEnd<bLength && b[bEnd]!='.'){
+			bNumeric = bNumeric && b[bEnd]>='0'&&b[bEnd]<='9';
+			bEnd++;
+		}
+
+		size_t aSize = aEnd-aPosition;
+		size_t bSize = bEnd-bPosition;
+
+		if(aNumeric && bNumeric){
+			//skip leading zeroes, then the longer number is the larger
+			while(aSize>1 && a[aPosition]=='0'){ aPosition++; aSize--; }
+			while(bSize>1 && b[bPosition]=='0'){ bPosition++; bSize--; }
+
+			if(aSize!=bSize) return aSize<bSize?-1:1;
+		}else if(aNumeric!=bNumeric){
+			return aNumeric?-1:1;
+		}
+
+		int result = memcmp(a+aPosition, b+bPosition, MIN(aSize, bSize));
+		if(result) return result<0?-1:1;
+		if(aSize!=bSize) return aSize<bSize?-1:1;
+
+		aPosition = aEnd+1;
+		bPosition = bEnd+1;
+	}
+
+	if(aPosition<aLength) return 1;
+	if(bPosition<bLength) return -1;
+
+	return 0;
 }
 
-void read_electron_requirement(char **requirement, char *data) {
-	jsmn_parser jsonParser;
-	jsmntok_t *json;
+int version_compare(const Version *a, const Version *b) {
+	if(a->key!=b->key) return a->key<b->key?-1:1;
+	if(!a->prerelease || !b->prerelease) return 0;
 
-	*requirement = NULL;
+	return _version_compare_prerelease(a->prerelease, a->prereleaseLength, b->prerelease, b->prereleaseLength);
+}
 
-	int parsed = json_init(&jsonParser, &json, data);
+// a single comparison, that everything in a range is reduced to
+typedef struct {
+	char op;                              //'<', '>' or '='
+	bool inclusive;
+	uint64_t key;
+	const char *prerelease;               //NULL for a release, or empty for below every prerelease of its version
+	size_t prereleaseLength;
+} _Version_comparator;
+
+// a version as written in a range, which may leave off parts or give them as "x" or "*"
+typedef struct {
+	uint64_t parts[3];
+	unsigned count;                       //parts given
+	const char *prerelease;
+	size_t prereleaseLength;
+} _Version_partial;
 
-	if(!json||parsed<1||json[0].type!=JSMN_OBJECT){
-		fprintf(stderr, "Error parsing package.json\n");
-		free(json);
+typedef struct {
+	_Version_comparator comparators[VERSION_COMPARATORS_MAXIMUM];
+	unsigned count;
+	bool empty;                           //contains something that can never match
+} _Version_set;
+
+static bool _version_partial_parse(const char **string, _Version_partial *partial) {
+	const char *position = *string;
+	memset(partial, 0, sizeof(*partial));
+
+	while(*position=='v'||*position=='V'||*position=='=') position++;
+
+	bool wildcard = false;
+	for(unsigned i=0; i<3; i++){
+		if(i>0){
+			if(*position!='.') break;
+			position++;
+		}
+
+		if(*position=='x'||*position=='X'||*position=='*'){
+			wildcard = true;
+			position++;
+
+		}else if(*position>='0'&&*position<='9'){
+			uint64_t part = 0;
+			for(; *position>='0'&&*position<='9'; position++){
+				part = MIN(part*10+(*position-'0'), VERSION_PART_MAXIMUM+1);
+			}
+
+			if(!wildcard){
+				partial->parts[i] = part;
+				partial->count++;
+			}
+
+		}else{
+			return false;
+		}
+	}
+
+	if(*position=='-' && partial->count==3){
+		size_t length = _version_identifiers(position+1);
+		if(!length || !_version_prerelease_valid(position+1, length)) return false;
+
+		partial->prerelease = position+1;
+		partial->prereleaseLength = length;
+		position += 1+length;
+	}
+
+	if(*position=='+'){
+		size_t length = _version_identifiers(position+1);
+		if(!length) return false;
+
+		position += 1+length;
+	}
+
+	if(*position && *position!=' ' && *position!='\t' && *position!='|') return false;
+
+	*string = position;
+
+	return true;
+}
+
+static void _version_set_add(_Version_set *set, char op, bool inclusive, uint64_t major, uint64_t minor, uint64_t patch, const char *prerelease, size_t prereleaseLength) {
+	if(major>VERSION_PART_MAXIMUM || minor>VERSION_PART_MAXIMUM || patch>VERSION_PART_MAXIMUM){
+		//beyond anything a key can hold, so only bounds from above (which then bound nothing) can be this high
+		if(op!='<') set->empty = true;
+		return;
+	}
+
+	//as with npm, ">=0.0.0" is taken to be no bound at all (so lets through prereleases of 0.0.0)
+	if(op=='>' && inclusive && !prerelease && !major && !minor && !patch) return;
+
+	if(set->count>=VERSION_COMPARATORS_MAXIMUM){
+		set->empty = true;
 		return;
 	}
 
-	int depPosition = 1;
-	if(json_find(json, parsed, data, 0, &depPosition, "dependencies", JSMN_OBJECT)){
+	set->comparators[set->count++] = (_Version_comparator){
+		.op = op,
+		.inclusive = inclusive,
+		.key = _version_pack(major, minor, patch, !prerelease),
+		.prerelease = prerelease,
+		.prereleaseLength = prereleaseLength
+	};
+}
+
+// adds a bound from below every prerelease of a version (as in "<2.0.0-0")
+static void _version_set_add_floor(_Version_set *set, uint64_t major, uint64_t minor, uint64_t patch) {
+	_version_set_add(set, '<', false, major, minor, patch, "", 0);
+}
+
+// adds `op` `partial`, as npm reads it
+static void _version_set_add_partial(_Version_set *set, const char *op, const _Version_partial *partial) {
+	uint64_t major = partial->parts[0];
+	uint64_t minor = partial->parts[1];
+	uint64_t patch = partial->parts[2];
+	unsigned count = partial->count;
+
+	if(!op[0] || op[0]=='=' || !count && (!strcmp(op, ">=") || !strcmp(op, "<=") || op[0]=='~' || op[0]=='^')){
+		if(count==0) return; //anything
+
+		if(count==3){
+			_version_set_add(set, '=', true, major, minor, patch, partial->prerelease, partial->prereleaseLength);
+			return;
+		}
+
+		_version_set_add(set, '>', true, major, minor, 0, NULL, 0);
+		if(count==1) _version_set_add_floor(set, major+1, 0, 0);
+		if(count==2) _version_set_add_floor(set, major, minor+1, 0);
+
+	}else if(op[0]=='>'){
+		bool inclusive = op[1]=='=';
+
+		if(count==0){
+			set->empty = true;
+		}else if(count==3){
+			_version_set_add(set, '>', inclusive, major, minor, patch, partial->prerelease, partial->prereleaseLength);
+		}else if(count==1){
+			_version_set_add(set, '>', true, inclusive?major:major+1, 0, 0, NULL, 0);
+		}else{
+			_version_set_add(set, '>', true, major, inclusive?minor:minor+1, 0, NULL, 0);
+		}
+
+	}else if(op[0]=='<'){
+		bool inclusive = op[1]=='=';
+
+		if(count==0){
+			set->empty = true;
+		}else if(count==3){
+			_version_set_add(set, '<', inclusive, major, minor, patch, partial->prerelease, partial->prereleaseLength);
+		}else if(count==1){
+			_version_set_add_floor(set, inclusive?major+1:major, 0, 0);
+		}else{
+			_version_set_add_floor(set, major, inclusive?minor+1:minor, 0);
+		}
+
+	}else if(op[0]=='~'){
+		_version_set_add(set, '>', true, major, count>1?minor:0, count>2?patch:0, partial->prerelease, partial->prereleaseLength);
+		if(count==1){
+			_version_set_add_floor(set, major+1, 0, 0);
+		}else{
+			_version_set_add_floor(set, major, minor+1, 0);
+		}
+
+	}else if(op[0]=='^'){
+		_version_set_add(set, '>', true, major, count>1?minor:0, count>2?patch:0, partial->prerelease, partial->prereleaseLength);
+		if(major>0 || count==1){
+			_version_set_add_floor(set, major+1, 0, 0);
+		}else if(minor>0 || count==2){
+			_version_set_add_floor(set, 0, minor+1, 0);
+		}else{
+			_version_set_add_floor(set, 0, 0, patch+1);
+		}
+	}
+}
+
+static const char *_version_skip_space(const char *string) {
+	while(*string==' '||*string=='\t') string++;
+
+	return string;
+}
+
+// reads one set of comparators (up to the end, or the next "||")
+static bool _version_set_parse(const char **string, _Version_set *set) {
+	const char *position = _version_skip_space(*string);
+	memset(set, 0, sizeof(*set));
+
+	//a hyphen range ("1.2 - 2.3.4") is two bare versions with a lone "-" between them
+	if(*position>='0'&&*position<='9' || *position=='v' || *position=='x' || *position=='X' || *position=='*'){
+		const char *afterLow = position;
+		_Version_partial low;
+
+		if(_version_partial_parse(&afterLow, &low)){
+			const char *hyphen = _version_skip_space(afterLow);
+
+			if(hyphen>afterLow && hyphen[0]=='-' && (hyphen[1]==' '||hyphen[1]=='\t')){
+				const char *afterHigh = _version_skip_space(hyphen+1);
+				_Version_partial high;
+				if(!_version_partial_parse(&afterHigh, &high)) return false;
+
+				if(low.count>0){
+					_version_set_add(set, '>', true, low.parts[0], low.parts[1], low.parts[2], low.prerelease, low.prereleaseLength);
+				}
+
+				if(high.count==3){
+					_version_set_add(set, '<', true, high.parts[0], high.parts[1], high.parts[2], high.prerelease, high.prereleaseLength);
+				}else if(high.count>0){
+					_version_set_add_partial(set, "<=", &high);
+				}
+
+				position = _version_skip_space(afterHigh);
+				if(*position && *position!='|') return false;
+
+				*string = position;
+				return true;
+			}
+		}
+	}
 
-		int electronPosition = depPosition+1;
-		if(json_find(json, parsed, data, depPosition, &electronPosition, "electron-prebuilt", JSMN_STRING)){
-			*requirement = &data[json[electronPosition].start];
-			data[json[electronPosition].end] = '\0';
+	while(*position && *position!='|'){
+		char op[3] = "";
+
+		if(position[0]=='~' && position[1]=='>'){
+			op[0] = '~';
+			position += 2;
+		}else if(position[0]=='<'||position[0]=='>'){
+			op[0] = *position++;
+			if(*position=='=') op[1] = *position++;
+		}else if(position[0]=='~'||position[0]=='^'||position[0]=='='){
+			op[0] = *position++;
 		}
 
-		electronPosition = depPosition+1;
-		if(json_find(json, parsed, data, depPosition, &electronPosition, "electron", JSMN_STRING)){
-			*requirement = &data[json[electronPosition].start];
-			data[json[electronPosition].end] = '\0';
-		}
+		position = _version_skip_space(position);
+
+		_Version_partial partial;
+		if(!_version_partial_parse(&position, &partial)) return false;
+
+		_version_set_add_partial(set, op, &partial);
+
+		position = _version_skip_space(position);
+	}
+
+	*string = position;
+
+	return true;
+}
+
+static bool _version_range_add_interval(Version_range *range, uint64_t low, uint64_t high) {
+	Version_interval *intervals = realloc(range->intervals, (range->count+1)*sizeof(Version_interval));
+	if(!intervals) return false;
+
+	range->intervals = intervals;
+	range->intervals[range->count++] = (Version_interval){low, high};
+
+	return true;
+}
+
+// narrows a prerelease bound to the tighter of it and `prerelease`
+static void _version_bound_tighten(const char **bound, size_t *boundLength, bool *inclusive, const char *prerelease, size_t prereleaseLength, bool prereleaseInclusive, int direction) {
+	if(*bound){
+		int comparison = _version_compare_prerelease(prerelease, prereleaseLength, *bound, *boundLength)*direction;
+		if(comparison<0 || comparison==0 && (prereleaseInclusive || !*inclusive)) return;
+	}
+
+	*bound = prerelease;
+	*boundLength = prereleaseLength;
+	*inclusive = prereleaseInclusive;
+}
+
+static char *_version_copy(const char *string, size_t length) {
+	char *copy = malloc(length+1);
+	if(!copy) return NULL;
+
+	memcpy(copy, string, length);
+	copy[length] = '\0';
+
+	return copy;
+}
+
+// adds the prereleases of `key` allowed by `set`, if any are
+static bool _version_range_add_prereleases(Version_range *range, const _Version_set *set, uint64_t key) {
+	const char *low = NULL, *high = NULL;
+	size_t lowLength = 0, highLength = 0;
+	bool lowInclusive = false, highInclusive = false;
+
+	for(unsigned i=0; i<set->count; i++){
+		const _Version_comparator *comparator = &set->comparators[i];
+		uint64_t comparatorKey = comparator->key&~(uint64_t)VERSION_RELEASE;
+
+		if(comparatorKey!=key || !comparator->prerelease){
+			//every prerelease of `key` falls the same side of this one (below it, if it's the release of the same version)
+			bool below = comparatorKey!=key?key<comparatorKey:true;
+
+			if(comparator->op=='=' || comparator->op=='>'&&below || comparator->op=='<'&&!below) return true;
+			continue;
+		}
+
+		if(!comparator->prereleaseLength){
+			//below all of them
+			if(comparator->op!='>') return true;
+			continue;
+		}
+
+		if(comparator->op!='<') _version_bound_tighten(&low, &lowLength, &lowInclusive, comparator->prerelease, comparator->prereleaseLength, comparator->inclusive, 1);
+		if(comparator->op!='>') _version_bound_tighten(&high, &highLength, &highInclusive, comparator->prerelease, comparator->prereleaseLength, comparator->inclusive, -1);
+	}
+
+	if(low && high){
+		int comparison = _version_compare_prerelease(low, lowLength, high, highLength);
+		if(comparison>0 || comparison==0 && !(lowInclusive && highInclusive)) return true;
+	}
+
+	Version_prereleases *prereleases = realloc(range->prereleases, (range->prereleaseCount+1)*sizeof(Version_prereleases));
+	if(!prereleases) return false;
+
+	range->prereleases = prereleases;
+	range->prereleases[range->prereleaseCount++] = (Version_prereleases){
+		.key = key,
+		.low = low?_version_copy(low, lowLength):NULL,
+		.lowInclusive = lowInclusive,
+		.high = high?_version_copy(high, highLength):NULL,
+		.highInclusive = highInclusive
+	};
+
+	return true;
+}
+
+// adds what a set of comparators matches to the range
+static bool _version_range_add_set(Version_range *range, const _Version_set *set) {
+	if(set->empty) return true;
+
+	//releases fall within a single interval
+	uint64_t low = 0;
+	uint64_t high = UINT64_MAX;
+	bool empty = false;
+
+	for(unsigned i=0; i<set->count; i++){
+		const _Version_comparator *comparator = &set->comparators[i];
+		uint64_t key = comparator->key;
+
+		//releases never share the key of a prerelease, so bounds there are always exclusive
+		bool inclusive = comparator->inclusive && !comparator->prerelease;
+
+		if(comparator->op!='<'){
+			if(!inclusive && key==UINT64_MAX) empty = true;
+			else low = MAX(low, inclusive?key:key+1);
+		}
+
+		if(comparator->op!='>'){
+			if(!inclusive && key==0) empty = true;
+			else high = MIN(high, inclusive?key:key-1);
+		}
+	}
+
+	if(!empty && low<=high){
+		if(!_version_range_add_interval(range, low, high)) return false;
+	}
+
+	//prereleases only match where a comparator names one of the same version
+	for(unsigned i=0; i<set->count; i++){
+		const _Version_comparator *comparator = &set->comparators[i];
+		if(!comparator->prereleaseLength) continue;
+
+		bool repeated = false;
+		for(unsigned j=0; j<i; j++){
+			repeated = repeated || set->comparators[j].prereleaseLength && set->comparators[j].key==comparator->key;
+		}
+
+		if(!repeated && !_version_range_add_prereleases(range, set, comparator->key)) return false;
+	}
+
+	return true;
+}
+
+static int _version_compare_interval(const void *a, const void *b) {
+	const Version_interval *intervalA = a;
+	const Version_interval *intervalB = b;
+
+	if(intervalA->low!=intervalB->low) return intervalA->low<intervalB->low?-1:1;
+	return 0;
+}
+
+static int _version_compare_prereleases(const void *a, const void *b) {
+	const Version_prereleases *prereleasesA = a;
+	const Version_prereleases *prereleasesB = b;
+
+	if(prereleasesA->key!=prereleasesB->key) return prereleasesA->key<prereleasesB->key?-1:1;
+	return 0;
+}
+
+void version_range_free(Version_range *range) {
+	for(uint32_t i=0; i<range->prereleaseCount; i++){
+		free(range->prereleases[i].low);
+		free(range->prereleases[i].high);
+	}
+	free(range->prereleases);
+	free(range->intervals);
+	memset(range, 0, sizeof(*range));
+}
+
+// compiles an npm version range ("^1.2.3", "1.2.7 || >=1.2.9 <2.0.0", "1.x - 2.3" etc), returning false if it can't be read
+bool version_range_compile(Version_range *range, const char *requirement) {
+	memset(range, 0, sizeof(*range));
+
+	bool any = false;
+
+	const char *position = requirement;
+	while(true){
+		_Version_set set;
+		if(!_version_set_parse(&position, &set) || !_version_range_add_set(range, &set)){
+			version_range_free(range);
+			return false;
+		}
+
+		any = any || !set.count && !set.empty;
+
+		if(!*position) break;
+
+		if(position[0]!='|' || position[1]!='|'){
+			version_range_free(range);
+			return false;
+		}
+		position += 2;
+	}
+
+	if(any){
+		//as with npm, a set matching any release makes the whole range just that (so excluding prereleases the others allow)
+		version_range_free(range);
+		return _version_range_add_interval(range, 0, UINT64_MAX);
+	}
+
+	//merge the intervals of each set into one ordered list
+	if(range->count){
+		qsort(range->intervals, range->count, sizeof(Version_interval), _version_compare_interval);
+
+		uint32_t count = 1;
+		for(uint32_t i=1; i<range->count; i++){
+			Version_interval *last = &range->intervals[count-1];
+			const Version_interval *interval = &range->intervals[i];
+
+			if(last->high==UINT64_MAX || interval->low<=last->high+1){
+				last->high = MAX(last->high, interval->high);
+			}else{
+				range->intervals[count++] = *interval;
+			}
+		}
+		range->count = count;
+	}
+
+	if(range->prereleaseCount){
+		qsort(range->prereleases, range->prereleaseCount, sizeof(Version_prereleases), _version_compare_prereleases);
+	}
+
+	return true;
+}
+
+bool version_range_test(const Version_range *range, const Version *version) {
+	if(!version->prerelease){
+		//find the last interval starting at or below it
+		uint32_t low = 0;
+		uint32_t high = range->count;
+		while(low<high){
+			uint32_t middle = low+(high-low)/2;
+			if(range->intervals[middle].low<=version->key){
+				low = middle+1;
+			}else{
+				high = middle;
+			}
+		}
+
+		return low>0 && version->key<=range->intervals[low-1].high;
+	}
+
+	uint32_t low = 0;
+	uint32_t high = range->prereleaseCount;
+	while(low<high){
+		uint32_t middle = low+(high-low)/2;
+		if(range->prereleases[middle].key<version->key){
+			low = middle+1;
+		}else{
+			high = middle;
+		}
+	}
+
+	for(uint32_t i=low; i<range->prereleaseCount && range->prereleases[i].key==version->key; i++){
+		const Version_prereleases *prereleases = &range->prereleases[i];
+
+		if(prereleases->low){
+			int comparison = _version_compare_prerelease(version->prerelease, version->prereleaseLength, prereleases->low, strlen(prereleases->low));
+			if(comparison<0 || comparison==0 && !prereleases->lowInclusive) continue;
+		}
+
+		if(prereleases->high){
+			int comparison = _version_compare_prerelease(version->prerelease, version->prereleaseLength, prereleases->high, strlen(prereleases->high));
+			if(comparison>0 || comparison==0 && !prereleases->highInclusive) continue;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+// returns the highest key the range could match, or 0 if it matches nothing
+uint64_t version_range_ceiling(const Version_range *range) {
+	uint64_t ceiling = range->count?range->intervals[range->count-1].high:0;
+	if(range->prereleaseCount) ceiling = MAX(ceiling, range->prereleases[range->prereleaseCount-1].key);
+
+	return ceiling;
+}
+
+// returns true if the range can match no more than a single version
+bool version_range_exact(const Version_range *range) {
+	if(range->count+range->prereleaseCount>1) return false;
+
+	if(range->count) return range->intervals[0].low==range->intervals[0].high;
+
+	return !range->prereleaseCount || range->prereleases[0].low && range->prereleases[0].high && !strcmp(range->prereleases[0].low, range->prereleases[0].high);
+}
+
+// installed runtimes are listed in a small binary index beside the store, so launches needn't scan and parse every folder in it
+// the index notes when the store folder was last modified, and is rebuilt from a scan if that ever changes
+
+#define RUNTIME_INDEX_MAGIC "ESRI"
+#define RUNTIME_INDEX_VERSION 1
+#define RUNTIME_INDEX_HEADER_SIZE 24
+#define RUNTIME_INDEX_RECORD_SIZE 64
+#define RUNTIME_NAME_MAXIMUM 44       //longest folder name that fits in a record (including the terminator)
+
+#define RUNTIME_COMPLETE 0x1          //flag: fully installed
+
+typedef struct {
+	uint64_t key;                     //packed version, see version_parse()
+	uint64_t size;                    //bytes installed, or 0 if unknown
+	uint32_t flags;
+	char name[RUNTIME_NAME_MAXIMUM];  //folder within the store
+} Runtime;
+
+typedef struct {
+	Runtime *runtimes;                //in version order
+	uint32_t count;
+	int64_t storeTime;                //modification time of the store when indexed
+} Runtime_index;
+
+static void _write16(uint8_t *data, uint16_t value) { data[0] = value; data[1] = value>>8; }
+static void _write32(uint8_t *data, uint32_t value) { _write16(data, value); _write16(data+2, value>>16); }
+static void _write64(uint8_t *data, uint64_t value) { _write32(data, value); _write32(data+4, value>>32); }
+
+char *_runtime_index_filename() {
+	char *filename = malloc(MAX_PATH+16);
+	get_user_cache_folder(filename, MAX_PATH, PROGRAM_NAME);
+	strcat(filename, "runtime-index");
+
+	return filename;
+}
+
+// returns the modification time of the store, as finely as the system gives it (as entries added within the same second still need noticing)
+int64_t _runtime_store_time(const char *storePath) {
+	File_stamp stamp;
+	if(!file_stamp(storePath, &stamp)) return -1;
+
+	return stamp.time;
+}
+
+// returns the path of the executable within installed runtime `name`
+char *runtime_executable(const char *storePath, const char *name) {
+	#ifdef _WIN32
+		char *path = malloc(strlen(storePath)+strlen(name)+1+12+1);
+		sprintf(path, "%s%s" PATH_SEPARATOR "electron.exe", storePath, name);
+	#else
+		char *path = malloc(strlen(storePath)+strlen(name)+1+8+1);
+		sprintf(path, "%s%s" PATH_SEPARATOR "electron", storePath, name);
+	#endif
+
+	return path;
+}
+
+static int _runtime_compare(const void *a, const void *b) {
+	const Runtime *runtimeA = a;
+	const Runtime *runtimeB = b;
+
+	if(runtimeA->key!=runtimeB->key) return runtimeA->key<runtimeB->key?-1:1;
+
+	//prereleases of the same version need a closer look
+	Version versionA, versionB;
+	if(!version_parse(runtimeA->name, &versionA) || !version_parse(runtimeB->name, &versionB)) return 0;
+
+	return version_compare(&versionA, &versionB);
+}
+
+void runtime_index_free(Runtime_index *index) {
+	free(index->runtimes);
+	memset(index, 0, sizeof(*index));
+}
+
+// adds (or updates) runtime `name`, keeping the index in order
+bool runtime_index_add(Runtime_index *index, const char *name, uint64_t size, uint32_t flags) {
+	if(strlen(name)>=RUNTIME_NAME_MAXIMUM) return false;
+
+	Version version;
+	if(!version_parse(name, &version)) return false;
+
+	Runtime runtime = {
+		.key = version.key,
+		.size = size,
+		.flags = flags
+	};
+	strcpy(runtime.name, name);
+
+	for(uint32_t i=0; i<index->count; i++){
+		if(!strcmp(index->runtimes[i].name, name)){
+			index->runtimes[i] = runtime;
+			return true;
+		}
+	}
+
+	Runtime *runtimes = realloc(index->runtimes, (index->count+1)*sizeof(Runtime));
+	if(!runtimes) return false;
+
+	index->runtimes = runtimes;
+	index->runtimes[index->count++] = runtime;
+
+	qsort(index->runtimes, index->count, sizeof(Runtime), _runtime_compare);
+
+	return true;
+}
+
+// reads the index, returning false if there isn't one or it's out of date (although the entries of one out of date are still read, for their details to be carried over)
+bool runtime_index_read(Runtime_index *index, const char *storePath) {
+	memset(index, 0, sizeof(*index));
+
+	char *filename = _runtime_index_filename();
+	FILE *file = fopen(filename, "rb");
+	free(filename);
+
+	if(!file) return false;
+
+	uint8_t header[RUNTIME_INDEX_HEADER_SIZE];
+	bool valid = fread(header, sizeof(header), 1, file)==1
+		&& !memcmp(header, RUNTIME_INDEX_MAGIC, 4)
+		&& _read32(header+4)==RUNTIME_INDEX_VERSION;
+
+	uint32_t count = valid?_read32(header+8):0;
+
+	if(valid && count){
+		index->runtimes = malloc(count*sizeof(Runtime));
+		valid = index->runtimes!=NULL;
+
+		uint8_t record[RUNTIME_INDEX_RECORD_SIZE];
+		for(uint32_t i=0; valid && i<count; i++){
+			valid = fread(record, sizeof(record), 1, file)==1;
+			if(!valid) break;
+
+			Runtime *runtime = &index->runtimes[i];
+			runtime->key = _read64(record);
+			runtime->size = _read64(record+8);
+			runtime->flags = _read32(record+16);
+			memcpy(runtime->name, record+20, RUNTIME_NAME_MAXIMUM);
+			runtime->name[RUNTIME_NAME_MAXIMUM-1] = '\0';
+		}
+	}
+
+	fclose(file);
+
+	if(!valid){
+		runtime_index_free(index);
+		return false;
+	}
+
+	index->count = count;
+	index->storeTime = _read64(header+16);
+
+	return index->storeTime==_runtime_store_time(storePath);
+}
+
+// writes out the index, replacing the old one in a single step
+// it's stamped with the store time it was built from, so whatever changed after that is noticed on the next read
+bool runtime_index_write(Runtime_index *index, const char *storePath) {
+	char *filename = _runtime_index_filename();
+	char *temporaryFilename = malloc(strlen(filename)+64);
+	sprintf(temporaryFilename, "%s.%lld.%" PRIxPTR ".tmp", filename, (long long)getpid(), (uintptr_t)index); //each writer's own, as several may write at once
+
+	bool success = false;
+
+	FILE *file = fopen(temporaryFilename, "wb");
+	if(file){
+		uint8_t header[RUNTIME_INDEX_HEADER_SIZE] = {0};
+		memcpy(header, RUNTIME_INDEX_MAGIC, 4);
+		_write32(header+4, RUNTIME_INDEX_VERSION);
+		_write32(header+8, index->count);
+		_write64(header+16, index->storeTime);
+
+		success = fwrite(header, sizeof(header), 1, file)==1;
+
+		for(uint32_t i=0; success && i<index->count; i++){
+			const Runtime *runtime = &index->runtimes[i];
+
+			uint8_t record[RUNTIME_INDEX_RECORD_SIZE] = {0};
+			_write64(record, runtime->key);
+			_write64(record+8, runtime->size);
+			_write32(record+16, runtime->flags);
+			memcpy(record+20, runtime->name, RUNTIME_NAME_MAXIMUM);
+
+			success = fwrite(record, sizeof(record), 1, file)==1;
+		}
+
+		success = !fclose(file) && success;
+		success = success && rename_replace(temporaryFilename, filename);
+
+		if(!success){
+			remove(temporaryFilename);
+		}
+	}
+
+	free(temporaryFilename);
+	free(filename);
+
+	return success;
+}
+
+// rebuilds the index from the folders in the store, keeping what details it already has of those still there
+bool runtime_index_rebuild(Runtime_index *index, const char *storePath) {
+	Runtime_index previous = *index;
+	memset(index, 0, sizeof(*index));
+
+	//taken before looking, so anything added while the store is read leaves the index out of date rather than missing it
+	index->storeTime = _runtime_store_time(storePath);
+
+	#ifdef _WIN32
+		WIN32_FIND_DATA findData;
+
+		char *storePathSearch = malloc(strlen(storePath)+2);
+		strcpy(storePathSearch, storePath);
+		strcat(storePathSearch, "*"); //put a wildcard star on the end
+
+		HANDLE search = FindFirstFile(storePathSearch, &findData);
+			free(storePathSearch);
+
+			if(search==INVALID_HANDLE_VALUE && GetLastError()!=ERROR_FILE_NOT_FOUND){
+				on_error("Unable to access path: %s", storePath);
+				runtime_index_free(&previous);
+				return false;
+			}
+
+			if(search!=INVALID_HANDLE_VALUE){
+				do{
+					if(findData.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY && findData.cFileName[0]!='.'){
+						const char *name = findData.cFileName;
+	#else
+		DIR *dir = opendir(storePath);
+			if(!dir){
+				on_error("Unable to access path: %s", storePath);
+				runtime_index_free(&previous);
+				return false;
+			}
+
+			struct dirent *entry;
+			while(entry = readdir(dir)){
+				if(entry->d_type==DT_DIR && entry->d_name[0]!='.'){
+					const char *name = entry->d_name;
+	#endif
+						char *executable = runtime_executable(storePath, name);
+						struct stat info;
+						bool complete = !stat(executable, &info);
+						free(executable);
+
+						//the size isn't known without walking the whole thing, so is only kept from before
+						uint64_t size = 0;
+						for(uint32_t i=0; i<previous.count; i++){
+							if(!strcmp(previous.runtimes[i].name, name)){
+								size = previous.runtimes[i].size;
+								break;
+							}
+						}
+
+						runtime_index_add(index, name, size, complete?RUNTIME_COMPLETE:0);
+	#ifdef _WIN32
+					}
+				}while(FindNextFile(search, &findData));
+			}
+		FindClose(search);
+	#else
+				}
+			}
+		closedir(dir);
+	#endif
+
+	runtime_index_free(&previous);
+
+	return true;
+}
+
+// reads the index, rebuilding it if needed
+bool runtime_index_load(Runtime_index *index, const char *storePath) {
+	if(runtime_index_read(index, storePath)) return true;
+
+	if(!runtime_index_rebuild(index, storePath)) return false;
+
+	runtime_index_write(index, storePath);
+
+	return true;
+}
+
+// returns the newest complete runtime within `range`, if there is one
+const Runtime *runtime_index_best(const Runtime_index *index, const Version_range *range) {
+	//search down from the highest key that could possibly match
+	uint64_t ceiling = version_range_ceiling(range);
+
+	uint32_t low = 0;
+	uint32_t high = index->count;
+	while(low<high){
+		uint32_t middle = low+(high-low)/2;
+		if(index->runtimes[middle].key<=ceiling){
+			low = middle+1;
+		}else{
+			high = middle;
+		}
+	}
+
+	for(uint32_t i=low; i-->0;){
+		const Runtime *runtime = &index->runtimes[i];
+		if(!(runtime->flags&RUNTIME_COMPLETE)) continue;
+
+		Version version;
+		if(!version_parse(runtime->name, &version)) continue;
+
+		if(version_range_test(range, &version)) return runtime;
+	}
+
+	return NULL;
+}
+
+// each runtime holds a ".last_used" file, touched whenever it's launched, and locked (shared) for as long as it runs so it's never removed while in use
+
+char *_runtime_usage_filename(const char *runtimePath) {
+	char *filename = malloc(strlen(runtimePath)+1+10+1);
+	sprintf(filename, "%s" PATH_SEPARATOR ".last_used", runtimePath);
+
+	return filename;
+}
+
+// marks the runtime holding `executable` as used now, and holds it for as long as this process (or what it executes) runs
+// returns false if the runtime has gone
+bool runtime_use(const char *executable) {
+	char *runtimePath = strdup(executable);
+	char *separator = strrchr(runtimePath, PATH_SEPARATOR[0]);
+	if(separator) *separator = '\0';
+
+	char *filename = _runtime_usage_filename(runtimePath);
+
+	File_lock lock;
+	if(file_lock(filename, false, true, &lock)){
+		//deliberately never unlocked, so the lock is handed on through execvp
+		#ifdef _WIN32
+			FILETIME now;
+			GetSystemTimeAsFileTime(&now);
+			SetFileTime(lock, NULL, NULL, &now);
+		#else
+			futimens(lock, NULL);
+		#endif
+	}
+
+	free(filename);
+	free(runtimePath);
+
+	//it may have been removed while waiting for the lock
+	struct stat info;
+	return !stat(executable, &info);
+}
+
+// returns when runtime `name` was last launched (in seconds since the epoch), or failing that, when it was installed
+int64_t runtime_last_used(const char *storePath, const char *name) {
+	char *runtimePath = malloc(strlen(storePath)+strlen(name)+1);
+	sprintf(runtimePath, "%s%s", storePath, name);
+
+	char *filename = _runtime_usage_filename(runtimePath);
+
+	struct stat info;
+	int64_t time = !stat(filename, &info)||!stat(runtimePath, &info)?(int64_t)info.st_mtime:0;
+
+	free(filename);
+	free(runtimePath);
+
+	return time;
+}
+
+// each version is installed by one process at a time, holding "<store>.<version>.lock", while any others wanting it wait for it to finish
+// it's extracted into "<store>.<version>.staging" and renamed into place once complete, so the store never holds half a runtime under its real name
+// the installer's progress follows the (locked) first byte of the lock file, for those waiting to show
+
+#define INSTALL_WAIT_INTERVAL 100 //how often (in ms) those waiting check on the install
+
+static _Thread_local File_lock _installLock; //per thread, as several may install at once
+static _Thread_local bool _installLocked = false;
+static _Thread_local int _installSharedProgress; //as last written, so it's only written again once it changes
+static _Thread_local int _installStageFirst;     //the percentages of the whole install the stage in hand runs between
+static _Thread_local int _installStageLast;
+
+char *_install_lock_filename(const char *storePath, const char *name) {
+	char *filename = malloc(strlen(storePath)+1+strlen(name)+5+1);
+	sprintf(filename, "%s.%s.lock", storePath, name);
+	return filename;
+}
+
+char *install_staging_path(const char *storePath, const char *name) {
+	char *path = malloc(strlen(storePath)+1+strlen(name)+8+1);
+	sprintf(path, "%s.%s.staging", storePath, name);
+	return path;
+}
+
+static void _install_write_progress(int progress) {
+	progress = MAX(0, MIN(progress, 100));
+	if(!_installLocked || progress==_installSharedProgress) return;
+	_installSharedProgress = progress;
+
+	char text[8];
+	int length = snprintf(text, sizeof(text), "%3i", progress);
+
+	#ifdef _WIN32
+		OVERLAPPED overlapped = { .Offset = 1 };
+		DWORD written;
+		WriteFile(_installLock, text, length, &written, &overlapped);
+	#else
+		pwrite(_installLock, text, length, 1);
+	#endif
+}
+
+// shares the progress of the install in hand (if any) with those waiting on it, given this thread's `done` of `total` through the current stage
+// it never goes back within a stage, as one figure for the whole install rather than following each share as it starts
+void install_share_progress(uint64_t done, uint64_t total) {
+	if(!_installLocked) return;
+
+	int progress = _installStageFirst+(total?(int)(MIN(done, total)*(_installStageLast-_installStageFirst)/total):0);
+	_install_write_progress(MAX(progress, _installSharedProgress));
+}
+
+// starts the next stage of the install in hand (downloading, say, then extracting), which makes up `first` to `last` percent of it
+// whatever this thread reported for the stage before is done with, so the new one starts from nothing
+void install_stage(int first, int last) {
+	ui_progress(0, 0);
+
+	_installStageFirst = first;
+	_installStageLast = last;
+	_install_write_progress(first);
+}
+
+static int _install_read_progress(const char *filename) {
+	FILE *file = fopen(filename, "rb");
+	if(!file) return -1;
+
+	char text[8] = "";
+	bool read = !fseek(file, 1, SEEK_SET) && fread(text, 1, sizeof(text)-1, file)>0;
+	fclose(file);
+
+	return read?atoi(text):-1;
+}
+
+// takes the lock on installing `name`, first waiting for any other process installing it to finish
+// returns false if cancelled while waiting
+bool install_lock(const char *storePath, const char *name) {
+	char *filename = _install_lock_filename(storePath, name);
+
+	bool waiting = false;
+	bool missing = false;
+	bool locked;
+
+	while(true){
+		locked = file_lock(filename, true, false, &_installLock);
+
+		#ifndef _WIN32
+			//the lock file may have been removed along with its runtime since it was opened, leaving this holding nothing
+			struct stat lockInfo, fileInfo;
+			if(locked && (fstat(_installLock, &lockInfo) || stat(filename, &fileInfo) || lockInfo.st_ino!=fileInfo.st_ino || lockInfo.st_dev!=fileInfo.st_dev)){
+				file_unlock(&_installLock);
+				continue;
+			}
+		#endif
+
+		if(locked) break;
+
+		struct stat info;
+		if(stat(filename, &info)){
+			if(missing) break; //the lock can't even be created, so carry on without it
+			missing = true; //or it was just removed, so try again
+			continue;
+		}
+		missing = false;
+
+		if(!waiting){
+			waiting = true;
+			printf("Waiting for another install of Electron %s...\n", name);
+			ui_status("Waiting for another download...");
+		}
+
+		int progress = _install_read_progress(filename);
+		if(progress>=0){
+			ui_progress(progress, 100);
+		}
+
+		if(ui_is_cancelled()){
+			free(filename);
+			return false;
+		}
+
+		sleep_ms(INSTALL_WAIT_INTERVAL);
+	}
+
+	if(locked){
+		_installLocked = true;
+		_installSharedProgress = -1;
+
+		//start from nothing, in case the last install of this was interrupted
+		#ifdef _WIN32
+			SetFilePointer(_installLock, 0, NULL, FILE_BEGIN);
+			SetEndOfFile(_installLock);
+		#else
+			ftruncate(_installLock, 0);
+		#endif
+
+		install_stage(0, 100);
+	}
+
+	free(filename);
+
+	return true;
+}
+
+void install_unlock() {
+	if(!_installLocked) return;
+
+	_installLocked = false;
+	file_unlock(&_installLock);
+}
+
+// removes the lock file of `name`, unless it's being installed
+void install_lock_remove(const char *storePath, const char *name) {
+	char *filename = _install_lock_filename(storePath, name);
+
+	File_lock lock;
+	if(file_lock(filename, true, false, &lock)){
+		remove(filename);
+		file_unlock(&lock);
+	}
+
+	free(filename);
+}
+
+// moves a complete install from `stagingPath` to runtime `name`, replacing anything incomplete left there
+bool install_publish(const char *stagingPath, const char *storePath, const char *name) {
+	char *runtimePath = malloc(strlen(storePath)+strlen(name)+1);
+	sprintf(runtimePath, "%s%s", storePath, name);
+
+	remove_directory(runtimePath);
+
+	//everything installed has to be on disk before the move is, or a crash could leave a runtime in place with files missing
+	sync_filesystem(stagingPath);
+
+	bool published = !rename(stagingPath, runtimePath);
+	if(!published){
+		on_error("Unable to move \"%s\" into place", stagingPath);
+	}else{
+		sync_directory(storePath);
+	}
+
+	free(runtimePath);
+
+	return published;
+}
+
+void print_downloads(){
+	char path[MAX_PATH+8];
+	get_user_cache_folder(path, MAX_PATH, PROGRAM_NAME);
+	strcat(path, "runtime" PATH_SEPARATOR);
+
+	#ifdef _WIN32
+		mkdir(path);
+	#else
+		mkdir(path, 0700);
+	#endif
+
+	Runtime_index index;
+	if(!runtime_index_load(&index, path)) return;
+
+	printf("Currently downloaded Electron runtimes (%s):\n", path);
+
+	for(uint32_t i=0; i<index.count; i++){
+		const Runtime *runtime = &index.runtimes[i];
+
+		printf("  %s", runtime->name);
+		if(runtime->size) printf(" (%.1f MB)", runtime->size/(1024.0*1024.0));
+		if(!(runtime->flags&RUNTIME_COMPLETE)) printf(" (incomplete)");
+		printf("\n");
+	}
+
+	if(!index.count){
+		printf("  none found\n");
+	}
+
+	runtime_index_free(&index);
+}
+
+// each launch remembers what its project resolved to, so the next can go straight to the runtime once a couple of stats show nothing has changed
+
+typedef struct {
+	char *projectPath;        //as launched (which may have gained ".asar")
+	char *packagePath;        //package.json, or the archive holding it
+	File_stamp packageStamp;
+	uint64_t packageHash;     //of package.json's content, to tell a real change from a touch
+	int64_t storeTime;        //modification time of the store, as a newer runtime may have arrived since
+	char *requirement;
+	char *runtime;
+	char *executable;
+} Resolution;
+
+// returns `path` made absolute, so the same project is recognised from wherever it's launched
+char *absolute_path(const char *path) {
+	#ifdef _WIN32
+		char *absolute = malloc(MAX_PATH+1);
+		DWORD length = GetFullPathName(path, MAX_PATH+1, absolute, NULL);
+		if(!length || length>MAX_PATH){
+			strcpy(absolute, path);
+		}
+
+		return absolute;
+
+	#else
+		if(path[0]=='/') return strdup(path);
+
+		char directory[MAX_PATH];
+		if(!getcwd(directory, sizeof(directory))) return strdup(path);
+
+		char *absolute = malloc(strlen(directory)+1+strlen(path)+1);
+		sprintf(absolute, "%s/%s", directory, path);
+
+		return absolute;
+	#endif
+}
+
+// returns the file holding the package.json of `projectPath`, which is either in a folder or an archive
+char *project_package_path(const char *projectPath) {
+	struct stat info;
+	if(!stat(projectPath, &info) && !S_ISDIR(info.st_mode)) return strdup(projectPath);
+
+	char *path = malloc(strlen(projectPath)+1+12+1);
+	sprintf(path, "%s" PATH_SEPARATOR "package.json", projectPath);
+
+	return path;
+}
+
+char *_resolution_filename(const char *project) {
+	char *filename = malloc(MAX_PATH+32);
+	get_user_cache_folder(filename, MAX_PATH, PROGRAM_NAME);
+	strcat(filename, "resolved" PATH_SEPARATOR);
+	#ifdef _WIN32
+		mkdir(filename);
+	#else
+		mkdir(filename, 0700);
+	#endif
+
+	sprintf(filename+strlen(filename), "%016" PRIx64, hash_string(project));
+
+	return filename;
+}
+
+void resolution_free(Resolution *resolution) {
+	free(resolution->projectPath);
+	free(resolution->packagePath);
+	free(resolution->requirement);
+	free(resolution->runtime);
+	free(resolution->executable);
+	memset(resolution, 0, sizeof(*resolution));
+}
+
+// reads what `project` last resolved to, if anything
+bool resolution_read(Resolution *resolution, const char *project) {
+	memset(resolution, 0, sizeof(*resolution));
+
+	char *filename = _resolution_filename(project);
+	FILE *file = fopen(filename, "rb");
+	free(filename);
+
+	if(!file) return false;
+
+	bool matched = false;
+	char line[MAX_PATH+32];
+
+	while(fgets(line, sizeof(line), file)){
+		line[strcspn(line, "\r\n")] = '\0';
+
+		if(!strncmp(line, "project ", 8)){
+			matched = !strcmp(line+8, project); //or a hash collision
+			if(!matched) break;
+
+		}else if(!strncmp(line, "path ", 5)){
+			resolution->projectPath = strdup(line+5);
+
+		}else if(!strncmp(line, "package ", 8)){
+			resolution->packagePath = strdup(line+8);
+
+		}else if(!strncmp(line, "size ", 5)){
+			resolution->packageStamp.size = strtoull(line+5, NULL, 10);
+
+		}else if(!strncmp(line, "time ", 5)){
+			resolution->packageStamp.time = strtoll(line+5, NULL, 10);
+
+		}else if(!strncmp(line, "hash ", 5)){
+			resolution->packageHash = strtoull(line+5, NULL, 16);
+
+		}else if(!strncmp(line, "store-time ", 11)){
+			resolution->storeTime = strtoll(line+11, NULL, 10);
+
+		}else if(!strncmp(line, "requirement ", 12)){
+			resolution->requirement = strdup(line+12);
+
+		}else if(!strncmp(line, "runtime ", 8)){
+			resolution->runtime = strdup(line+8);
+
+		}else if(!strncmp(line, "executable ", 11)){
+			resolution->executable = strdup(line+11);
+		}
+	}
+
+	fclose(file);
+
+	if(!matched || !resolution->projectPath || !resolution->packagePath || !resolution->requirement || !resolution->runtime || !resolution->executable){
+		resolution_free(resolution);
+		return false;
+	}
+
+	return true;
+}
+
+// records what `project` resolved to, replacing what was there in a single step
+bool resolution_write(const Resolution *resolution, const char *project) {
+	char *filename = _resolution_filename(project);
+	char *temporaryFilename = malloc(strlen(filename)+64);
+	sprintf(temporaryFilename, "%s.%lld.%" PRIxPTR ".tmp", filename, (long long)getpid(), (uintptr_t)temporaryFilename); //each writer's own, as several may write at once
+
+	bool success = false;
+
+	FILE *file = fopen(temporaryFilename, "wb");
+	if(file){
+		fprintf(file, "project %s\n", project);
+		fprintf(file, "path %s\n", resolution->projectPath);
+		fprintf(file, "package %s\n", resolution->packagePath);
+		fprintf(file, "size %llu\n", (unsigned long long)resolution->packageStamp.size);
+		fprintf(file, "time %lld\n", (long long)resolution->packageStamp.time);
+		fprintf(file, "hash %016" PRIx64 "\n", resolution->packageHash);
+		fprintf(file, "store-time %lld\n", (long long)resolution->storeTime);
+		fprintf(file, "requirement %s\n", resolution->requirement);
+		fprintf(file, "runtime %s\n", resolution->runtime);
+		fprintf(file, "executable %s\n", resolution->executable);
+
+		success = !ferror(file);
+		success = !fclose(file) && success;
+		success = success && rename_replace(temporaryFilename, filename);
+
+		if(!success){
+			remove(temporaryFilename);
+		}
+	}
+
+	free(temporaryFilename);
+	free(filename);
+
+	return success;
+}
+
+// checks a resolution still holds: that package.json is unchanged, and the store holds the same runtimes (including this one)
+bool resolution_check(Resolution *resolution, const char *project, const char *storePath) {
+	if(_runtime_store_time(storePath)!=resolution->storeTime) return false;
+
+	File_stamp stamp;
+	if(!file_stamp(resolution->packagePath, &stamp)) return false;
+
+	if(stamp.size!=resolution->packageStamp.size || stamp.time!=resolution->packageStamp.time){
+		//something has written to it, but that needn't have changed it
+		File_view projectFile;
+		if(read_file(resolution->projectPath, "package.json", &projectFile)) return false;
+
+		uint64_t hash = hash_bytes(projectFile.data, projectFile.size);
+		file_view_free(&projectFile);
+
+		if(hash!=resolution->packageHash) return false;
+
+		resolution->packageStamp = stamp;
+		resolution_write(resolution, project);
+	}
+
+	struct stat info;
+	return !stat(resolution->executable, &info);
+}
+
+// zip archives are read directly from their central directory, so entries can be located (and extracted) without walking the whole file
+
+typedef struct {
+	char *name;
+	uint64_t offset;           //offset of the local file header
+	uint64_t end;              //offset of whatever follows this entry in the archive
+	uint64_t compressedSize;
+	uint64_t uncompressedSize;
+	uint32_t crc32;
+	uint32_t attributes;       //external file attributes
+	uint16_t method;
+	uint16_t madeBy;
+} Archive_entry;
+
+typedef struct {
+	Archive_entry *entries;    //sorted by offset
+	size_t entryCount;
+	uint64_t directoryOffset;
+	uint64_t directorySize;
+	uint64_t size;             //size of the whole archive
+} Archive;
+
+#define ARCHIVE_TAIL_SIZE (256*1024) //enough for the central directory of most Electron releases
+
+// finds the central directory, given the last `tailSize` bytes of an archive of `size` bytes
+bool archive_locate_directory(Archive *archive, const uint8_t *tail, size_t tailSize, uint64_t size) {
+	archive->entries = NULL;
+	archive->entryCount = 0;
+	archive->size = size;
+
+	if(tailSize<22) return false;
+
+	//the end of central directory record is followed by a comment of up to 64k, so search back for it
+	const uint8_t *end = NULL;
+	for(const uint8_t *record=tail+tailSize-22; record>=tail && record>=tail+tailSize-22-0xffff; record--){
+		if(_read32(record)==0x06054b50 && record+22+_read16(record+20)==tail+tailSize){
+			end = record;
+			break;
+		}
+	}
+	if(!end) return false;
+
+	archive->entryCount = _read16(end+10);
+	archive->directorySize = _read32(end+12);
+	archive->directoryOffset = _read32(end+16);
+
+	//zip64 archives store the real values in a separate record, pointed to by a locator just before this one
+	if(end-tail>=20 && _read32(end-20)==0x07064b50){
+		uint64_t recordOffset = _read64(end-20+8);
+		uint64_t tailOffset = size-tailSize;
+		if(recordOffset<tailOffset || recordOffset+56>size) return false;
+
+		const uint8_t *record = tail+(recordOffset-tailOffset);
+		if(_read32(record)!=0x06064b50) return false;
+
+		archive->entryCount = _read64(record+32);
+		archive->directorySize = _read64(record+40);
+		archive->directoryOffset = _read64(record+48);
+	}
+
+	return archive->directoryOffset+archive->directorySize<=size;
+}
+
+static int _archive_compare_offset(const void *a, const void *b) {
+	const Archive_entry *entryA = a;
+	const Archive_entry *entryB = b;
+
+	return entryA->offset<entryB->offset?-1:entryA->offset>entryB->offset?1:0;
+}
+
+// reads all entries from the central directory (as located by archive_locate_directory)
+bool archive_read_directory(Archive *archive, const uint8_t *directory) {
+	archive->entries = calloc(archive->entryCount?archive->entryCount:1, sizeof(Archive_entry));
+	if(!archive->entries){
+		fprintf(stderr, "Out of memory reading archive\n");
+		return false;
+	}
+
+	const uint8_t *record = directory;
+	const uint8_t *directoryEnd = directory+archive->directorySize;
+
+	for(size_t i=0; i<archive->entryCount; i++){
+		if(record+46>directoryEnd || _read32(record)!=0x02014b50) return false;
+
+		Archive_entry *entry = &archive->entries[i];
+
+		uint16_t nameLength = _read16(record+28);
+		uint16_t extraLength = _read16(record+30);
+		uint16_t commentLength = _read16(record+32);
+
+		if(record+46+nameLength+extraLength+commentLength>directoryEnd) return false;
+
+		entry->madeBy = _read16(record+4);
+		entry->method = _read16(record+10);
+		entry->crc32 = _read32(record+16);
+		entry->compressedSize = _read32(record+20);
+		entry->uncompressedSize = _read32(record+24);
+		entry->attributes = _read32(record+38);
+		entry->offset = _read32(record+42);
+
+		entry->name = malloc(nameLength+1);
+		memcpy(entry->name, record+46, nameLength);
+		entry->name[nameLength] = '\0';
+
+		//zip64 fields are only present for values that overflowed their 32bit field
+		for(const uint8_t *extra=record+46+nameLength; extra+4<=record+46+nameLength+extraLength; extra+=4+_read16(extra+2)){
+			if(_read16(extra)!=0x0001) continue;
+
+			const uint8_t *field = extra+4;
+			const uint8_t *fieldEnd = field+_read16(extra+2);
+
+			if(entry->uncompressedSize==0xffffffff && field+8<=fieldEnd){ entry->uncompressedSize = _read64(field); field += 8; }
+			if(entry->compressedSize==0xffffffff && field+8<=fieldEnd){ entry->compressedSize = _read64(field); field += 8; }
+			if(entry->offset==0xffffffff && field+8<=fieldEnd){ entry->offset = _read64(field); field += 8; }
+		}
+
+		record += 46+nameLength+extraLength+commentLength;
+	}
+
+	qsort(archive->entries, archive->entryCount, sizeof(Archive_entry), _archive_compare_offset);
+
+	for(size_t i=0; i<archive->entryCount; i++){
+		archive->entries[i].end = i+1<archive->entryCount?archive->entries[i+1].offset:archive->directoryOffset;
+	}
+
+	return true;
+}
+
+uint64_t archive_uncompressed_size(const Archive *archive) {
+	uint64_t size = 0;
+	for(size_t i=0; i<archive->entryCount; i++){
+		size += archive->entries[i].uncompressedSize;
+	}
+	return size;
+}
+
+void archive_free(Archive *archive) {
+	for(size_t i=0; i<archive->entryCount&&archive->entries; i++){
+		free(archive->entries[i].name);
+	}
+	free(archive->entries);
+	archive->entries = NULL;
+	archive->entryCount = 0;
+}
+
+// files extracted are also kept in a content addressed store of objects (named by their SHA-256 and permissions), which installed runtimes hardlink to, so files identical between versions are only stored once
+// objects are also found by the CRC-32 and size an archive lists for each entry, so a duplicate is recognised (and checked) without writing anything
+
+#define OBJECT_MINIMUM_SIZE (16*1024) //smaller files aren't worth sharing
+
+char *_object_path(const char *kind, const char *name) {
+	char *path = malloc(MAX_PATH+128);
+	get_user_cache_folder(path, MAX_PATH, PROGRAM_NAME);
+	strcat(path, "objects" PATH_SEPARATOR);
+	strcat(path, kind);
+	make_path(path);
+
+	strcat(path, PATH_SEPARATOR);
+	strcat(path, name);
+
+	return path;
+}
+
+static char *_object_crc_path(uint32_t crc32, uint64_t size, uint32_t mode) {
+	char name[64];
+	sprintf(name, "%08" PRIx32 "-%" PRIx64 "-%o", crc32, size, (unsigned)mode);
+
+	return _object_path("crc32", name);
+}
+
+static char *_object_digest_path(const uint8_t digest[32], uint32_t mode) {
+	char name[64+16];
+	for(unsigned i=0; i<32; i++){
+		sprintf(name+i*2, "%02x", digest[i]);
+	}
+	sprintf(name+64, "-%o", (unsigned)mode);
+
+	return _object_path("sha256", name);
+}
+
+// returns the path of an object that's likely to match an entry of `crc32`, `size` and `mode`, if there is one, along with its digest (for checking it really does)
+char *object_find(uint32_t crc32, uint64_t size, uint32_t mode, uint8_t digest[32]) {
+	char *recordPath = _object_crc_path(crc32, size, mode);
+	FILE *file = fopen(recordPath, "rb");
+	free(recordPath);
+
+	if(!file) return NULL;
+
+	bool found = fread(digest, 32, 1, file)==1;
+	fclose(file);
+
+	if(!found) return NULL;
+
+	char *object = _object_digest_path(digest, mode);
+
+	struct stat info;
+	if(stat(object, &info) || (uint64_t)info.st_size!=size){
+		free(object);
+		return NULL;
+	}
+
+	return object;
+}
+
+static bool _object_link(const char *object, const char *path) {
+	#ifdef _WIN32
+		return CreateHardLink(path, object, NULL);
+
+	#else
+		if(!link(object, path)) return true;
+
+		#if defined(__linux__) && defined(FICLONE)
+			int source = open(object, O_RDONLY);
+			if(source<0) return false;
+
+			struct stat info;
+			int destination = fstat(source, &info)?-1:open(path, O_WRONLY|O_CREAT|O_EXCL, info.st_mode&0777);
+
+			bool cloned = destination>=0 && !ioctl(destination, FICLONE, source);
+
+			if(destination>=0) close(destination);
+			close(source);
+
+			if(destination>=0 && !cloned) unlink(path);
+
+			return cloned;
+
+		#elif defined(__APPLE__)
+			return !clonefile(object, path, 0);
+
+		#else
+			return false;
+		#endif
+	#endif
+}
+
+// makes `path` share the contents of `object`, as a hardlink, or failing that a copy-on-write clone (leaving `path` as it was if neither can be made)
+bool object_link(const char *object, const char *path) {
+	char *temporaryPath = malloc(strlen(path)+8+1);
+	sprintf(temporaryPath, "%s.object", path);
+
+	unlink(temporaryPath);
+	bool linked = _object_link(object, temporaryPath);
+
+	linked = linked && rename_replace(temporaryPath, path);
+	unlink(temporaryPath); //left behind if `path` was already the same file
+
+	free(temporaryPath);
+
+	return linked;
+}
+
+// adds the file at `path` (with `digest`, as extracted from an entry of `crc32`, `size` and `mode`) to the store, or if it's already there, links to that copy instead
+void object_store(const char *path, uint32_t crc32, uint64_t size, uint32_t mode, const uint8_t digest[32]) {
+	char *object = _object_digest_path(digest, mode);
+
+	#ifdef _WIN32
+		bool stored = CreateHardLink(object, path, NULL) || GetLastError()==ERROR_ALREADY_EXISTS && object_link(object, path);
+	#else
+		bool stored = !link(path, object) || errno==EEXIST && object_link(object, path);
+	#endif
+
+	free(object);
+
+	if(!stored) return;
+
+	//record it under the details the archive gives, replacing any record there was (which would be of different contents, or it'd have been used)
+	char *recordPath = _object_crc_path(crc32, size, mode);
+	char *temporaryPath = malloc(strlen(recordPath)+32);
+	sprintf(temporaryPath, "%s.%016" PRIx64 ".tmp", recordPath, hash_string(path));
+
+	FILE *file = fopen(temporaryPath, "wb");
+	if(file){
+		bool written = fwrite(digest, 32, 1, file)==1;
+		written = !fclose(file) && written;
+
+		if(!written || !rename_replace(temporaryPath, recordPath)){
+			remove(temporaryPath);
+		}
+	}
+
+	free(temporaryPath);
+	free(recordPath);
+}
+
+static int _file_link_count(const char *path) {
+	#ifdef _WIN32
+		HANDLE file = CreateFile(path, 0, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if(file==INVALID_HANDLE_VALUE) return -1;
+
+		BY_HANDLE_FILE_INFORMATION info;
+		int count = GetFileInformationByHandle(file, &info)?(int)info.nNumberOfLinks:-1;
+		CloseHandle(file);
+
+		return count;
+
+	#else
+		struct stat info;
+		return stat(path, &info)?-1:(int)info.st_nlink;
+	#endif
+}
+
+static void _on_object_prune(const char *path, const char *name, bool directory, void *data) {
+	unsigned *removed = data;
+	if(directory) return;
+
+	char *object = malloc(strlen(path)+1+strlen(name)+1);
+	sprintf(object, "%s" PATH_SEPARATOR "%s", path, name);
+
+	//linked from no runtime
+	if(_file_link_count(object)==1 && !unlink(object)){
+		(*removed)++;
+	}
+
+	free(object);
+}
+
+static void _on_object_record_prune(const char *path, const char *name, bool directory, void *data) {
+	if(directory) return;
+
+	char *record = malloc(strlen(path)+1+strlen(name)+1);
+	sprintf(record, "%s" PATH_SEPARATOR "%s", path, name);
+
+	const char *mode = strrchr(name, '-');
+	uint8_t digest[32];
+
+	FILE *file = fopen(record, "rb");
+	bool valid = file && fread(digest, 32, 1, file)==1 && mode && !strstr(name, ".tmp");
+	if(file) fclose(file);
+
+	if(valid){
+		char *object = _object_digest_path(digest, strtoul(mode+1, NULL, 8));
+		struct stat info;
+		valid = !stat(object, &info);
+		free(object);
+	}
+
+	if(!valid) unlink(record);
+
+	free(record);
+}
+
+// removes objects no longer used by any runtime (along with the records of them), returning how many were removed
+unsigned object_prune() {
+	unsigned removed = 0;
+
+	char *objects = _object_path("sha256", "");
+	objects[strlen(objects)-1] = '\0'; //without the trailing separator
+	directory_visit(objects, _on_object_prune, &removed);
+	free(objects);
+
+	char *records = _object_path("crc32", "");
+	records[strlen(records)-1] = '\0';
+	directory_visit(records, _on_object_record_prune, NULL);
+	free(records);
+
+	return removed;
+}
+
+// runtimes are removed least recently used first, once the store exceeds the size or count set, but never while in use or within a few days of use
+// they're first moved aside in a single rename (under an exclusive lock of their usage file), so nothing ever sees one half removed
+
+#define RUNTIME_KEEP_DAYS 30 //default days after use that runtimes are always kept for
+
+typedef struct {
+	uint64_t maximumSize;     //bytes the store is kept within (by the sizes recorded on install), or 0 for no limit
+	uint32_t maximumCount;    //runtimes the store is kept within, or 0 for no limit
+	int64_t keepTime;         //seconds after use that runtimes are always kept for
+} Runtime_policy;
+
+// reads the policy set by ELECTRON_SHARED_MAX_SIZE (in MB), ELECTRON_SHARED_MAX_COUNT and ELECTRON_SHARED_KEEP_DAYS
+void runtime_policy_read(Runtime_policy *policy) {
+	policy->maximumSize = (uint64_t)MAX(0, config_get_number("MAX_SIZE", 0))*1024*1024;
+	policy->maximumCount = MAX(0, config_get_number("MAX_COUNT", 0));
+	policy->keepTime = (int64_t)MAX(0, config_get_number("KEEP_DAYS", RUNTIME_KEEP_DAYS))*24*60*60;
+}
+
+char *_runtime_trash_path() {
+	char *path = malloc(MAX_PATH+16);
+	get_user_cache_folder(path, MAX_PATH, PROGRAM_NAME);
+	strcat(path, "trash");
+
+	return path;
+}
+
+// removes runtime `name`, unless it's in use
+bool runtime_evict(const char *storePath, const char *name) {
+	char *runtimePath = malloc(strlen(storePath)+strlen(name)+1);
+	sprintf(runtimePath, "%s%s", storePath, name);
+
+	char *usageFilename = _runtime_usage_filename(runtimePath);
+
+	char *trashPath = _runtime_trash_path();
+	make_path(trashPath);
+	trashPath = realloc(trashPath, strlen(trashPath)+1+strlen(name)+32);
+	sprintf(trashPath+strlen(trashPath), PATH_SEPARATOR "%s.%lld", name, (long long)getpid());
+
+	bool removed = false;
+
+	File_lock lock;
+	if(file_lock(usageFilename, true, false, &lock)){
+		#ifdef _WIN32
+			//open files can't be moved, although the running runtime will still stop this one being
+			file_unlock(&lock);
+			removed = MoveFileEx(runtimePath, trashPath, 0);
+		#else
+			removed = !rename(runtimePath, trashPath);
+			file_unlock(&lock);
+		#endif
+	}
+
+	if(removed){
+		remove_directory(trashPath);
+		install_lock_remove(storePath, name);
+	}
+
+	free(trashPath);
+	free(usageFilename);
+	free(runtimePath);
+
+	return removed;
+}
+
+typedef struct {
+	uint32_t index;
+	int64_t lastUsed;
+} _Runtime_usage;
+
+static int _runtime_compare_usage(const void *a, const void *b) {
+	const _Runtime_usage *usageA = a;
+	const _Runtime_usage *usageB = b;
+
+	return usageA->lastUsed<usageB->lastUsed?-1:usageA->lastUsed>usageB->lastUsed?1:0;
+}
+
+// removes runtimes as `policy` requires, keeping `keep` (if set), and if `expire` is set also any not used within the policy's keep time
+// returns how many were removed
+unsigned runtime_collect(Runtime_index *index, const char *storePath, const Runtime_policy *policy, const char *keep, bool expire) {
+	{ //clear up after any earlier collection that didn't finish
+		char *trashPath = _runtime_trash_path();
+		remove_directory(trashPath);
+		free(trashPath);
+	}
+
+	if(!index->count) return 0;
+
+	_Runtime_usage *usage = malloc(index->count*sizeof(_Runtime_usage));
+	if(!usage) return 0;
+
+	uint64_t size = 0;
+	for(uint32_t i=0; i<index->count; i++){
+		usage[i].index = i;
+		usage[i].lastUsed = runtime_last_used(storePath, index->runtimes[i].name);
+		size += index->runtimes[i].size;
+	}
+
+	qsort(usage, index->count, sizeof(_Runtime_usage), _runtime_compare_usage);
+
+	int64_t now = time(NULL);
+	uint32_t count = index->count;
+	unsigned removedCount = 0;
+
+	for(uint32_t i=0; i<index->count; i++){
+		const Runtime *runtime = &index->runtimes[usage[i].index];
+		if(keep && !strcmp(runtime->name, keep)) continue;
+
+		bool recent = now-usage[i].lastUsed<policy->keepTime;
+		bool over = policy->maximumCount && count>policy->maximumCount || policy->maximumSize && size>policy->maximumSize;
+
+		if(recent || !over && !expire) continue;
+
+		if(!runtime_evict(storePath, runtime->name)) continue;
+
+		printf("Removed Electron %s\n", runtime->name);
+
+		removedCount++;
+		count--;
+		size -= MIN(size, runtime->size);
+	}
+
+	if(removedCount){
+		//look again rather than take out what went, so the index is stamped with a store time it matches
+		if(runtime_index_rebuild(index, storePath)){
+			runtime_index_write(index, storePath);
+		}
+
+		object_prune();
+	}
+
+	free(usage);
+
+	return removedCount;
+}
+
+// removes whatever runtimes the configured policy allows, along with any not used within its keep time
+bool collect_garbage() {
+	char storePath[MAX_PATH+8];
+	get_user_cache_folder(storePath, MAX_PATH, PROGRAM_NAME);
+	strcat(storePath, "runtime" PATH_SEPARATOR);
+
+	Runtime_index index;
+	if(!runtime_index_load(&index, storePath)) return false;
+
+	Runtime_policy policy;
+	runtime_policy_read(&policy);
+
+	unsigned removed = runtime_collect(&index, storePath, &policy, NULL, true);
+	if(!removed){
+		//runtimes removed by hand leave objects behind, too
+		object_prune();
+	}
+
+	printf("Removed %u Electron runtime%s, %u kept\n", removed, removed==1?"":"s", index.count);
+
+	runtime_index_free(&index);
+
+	return true;
+}
+
+// DEFLATE (RFC 1951), decoded with the bit buffer refilled a word at a time, and codes looked up in tables wide enough that almost all take a single step
+// output collects in a buffer behind the 32K of history matches can reach back into, and is passed on a chunk at a time
+
+#define INFLATE_LITERAL_BITS  11          //primary table bits for literals and lengths (longer codes go through a subtable)
+#define INFLATE_DISTANCE_BITS 8
+#define INFLATE_CODE_BITS     7           //code length codes are never longer, so need no subtables
+#define INFLATE_WINDOW        (32*1024)
+#define INFLATE_CHUNK         (1024*1024) //output passed on at a time, at most
+#define INFLATE_MARGIN        (258+8)     //room for the longest match, plus the word it's copied past its end by
+
+//primary tables, plus a subtable of up to 15 bits for every symbol (more than enough)
+#define INFLATE_LITERAL_TABLE  ((1<<INFLATE_LITERAL_BITS)+288*(1<<(15-INFLATE_LITERAL_BITS)))
+#define INFLATE_DISTANCE_TABLE ((1<<INFLATE_DISTANCE_BITS)+32*(1<<(15-INFLATE_DISTANCE_BITS)))
+
+//table entries pack a symbol's value (or subtable offset) in bits 16-31, its kind in 12-15, its extra bits (or subtable bits) in 8-11 and its code length in 0-7
+#define _INFLATE_ENTRY(value, kind, extra) ((uint32_t)(value)<<16|(kind)<<12|(extra)<<8)
+#define _INFLATE_LITERAL  0
+#define _INFLATE_BASE     1 //a length or distance, to which its extra bits are added
+#define _INFLATE_SUBTABLE 2
+#define _INFLATE_END      3
+#define _INFLATE_INVALID  4
+
+enum {
+	_INFLATE_LITERALS,
+	_INFLATE_DISTANCES,
+	_INFLATE_CODES
+};
+
+static const uint16_t _inflateLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t _inflateLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t _inflateDistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t _inflateDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+typedef struct {
+	const uint8_t *in;
+	const uint8_t *inEnd;
+	uint64_t bits;                    //bits above bitCount are either zero, or the input following `in`
+	unsigned bitCount;
+	unsigned overrun;                 //zero bytes supplied past the end of the input
+
+	uint8_t *window;                  //output, after whatever history is kept
+	uint8_t *windowEnd;
+	uint8_t *out;
+	uint8_t *flushed;                 //output not yet passed on starts here
+	uint8_t *limit;                   //output is passed on once past here
+	uint64_t remaining;               //output expected, less what's been passed on
+	int (*put)(const void *buffer, int length, void *data);
+	void *data;
+
+	uint32_t literals[INFLATE_LITERAL_TABLE];
+	uint32_t distances[INFLATE_DISTANCE_TABLE];
+	const uint32_t *literalTable;     //the tables in use: those above, or the fixed code's
+	const uint32_t *distanceTable;
+	unsigned literalBits;             //primary bits of each
+	unsigned distanceBits;
+} _Inflate;
+
+static uint32_t _inflate_symbol(int alphabet, unsigned symbol) {
+	switch(alphabet){
+		case _INFLATE_LITERALS:
+			if(symbol<256) return _INFLATE_ENTRY(symbol, _INFLATE_LITERAL, 0);
+			if(symbol==256) return _INFLATE_ENTRY(0, _INFLATE_END, 0);
+			if(symbol<286) return _INFLATE_ENTRY(_inflateLengthBase[symbol-257], _INFLATE_BASE, _inflateLengthExtra[symbol-257]);
+			return _INFLATE_ENTRY(0, _INFLATE_INVALID, 0);
+		case _INFLATE_DISTANCES:
+			if(symbol<30) return _INFLATE_ENTRY(_inflateDistanceBase[symbol], _INFLATE_BASE, _inflateDistanceExtra[symbol]);
+			return _INFLATE_ENTRY(0, _INFLATE_INVALID, 0);
+		default:
+			return _INFLATE_ENTRY(symbol, _INFLATE_LITERAL, 0);
+	}
+}
+
+// builds the decoding `table` for the canonical code given by `lengths`, returning false if they don't form a valid code
+// its primary part takes up to `tableBits` bits, narrowed to the longest code (so short blocks needn't fill a wide table)
+static bool _inflate_table(uint32_t *table, size_t tableSize, unsigned *tableBitsOut, const uint8_t *lengths, unsigned count, int alphabet) {
+	unsigned counts[16] = {0};
+	unsigned maxLength = 0;
+	for(unsigned i=0; i<count; i++){
+		counts[lengths[i]]++;
+		maxLength = MAX(maxLength, lengths[i]);
+	}
+	counts[0] = 0;
+
+	unsigned tableBits = MIN(*tableBitsOut, maxLength);
+	*tableBitsOut = tableBits;
+
+	bool complete;
+	{ //refuse oversubscribed codes (incomplete ones are allowed, as a single distance code must be)
+		int left = 1;
+		for(unsigned length=1; length<16; length++){
+			left = (left<<1)-counts[length];
+			if(left<0) return false;
+		}
+		complete = !left;
+	}
+
+	//order symbols by code length, as their codes are assigned
+	uint16_t sorted[288];
+	unsigned offsets[16];
+	for(unsigned length=1, offset=0; length<16; length++){
+		offsets[length] = offset;
+		offset += counts[length];
+	}
+	unsigned total = 0;
+	for(unsigned i=0; i<count; i++){
+		if(lengths[i]){
+			sorted[offsets[lengths[i]]++] = i;
+			total++;
+		}
+	}
+
+	const uint32_t invalid = _INFLATE_ENTRY(0, _INFLATE_INVALID, 0);
+	size_t primarySize = (size_t)1<<tableBits;
+	if(!complete){ //otherwise every entry is written below
+		for(size_t i=0; i<primarySize; i++) table[i] = invalid;
+	}
+
+	size_t used = primarySize;
+	unsigned subtablePrefix = ~0u;
+	size_t subtableStart = 0;
+	unsigned subtableBits = 0;
+
+	//codes are read from their first bit, which is the lowest in the bit buffer, so are kept reversed
+	unsigned reversed = 0;
+
+	for(unsigned i=0; i<total; i++){
+		unsigned symbol = sorted[i];
+		unsigned length = lengths[symbol];
+		uint32_t entry = _inflate_symbol(alphabet, symbol);
+
+		if(length<=tableBits){
+			for(size_t index=reversed; index<primarySize; index+=(size_t)1<<length) table[index] = entry|length;
+		}else{
+			unsigned prefix = reversed&(primarySize-1);
+
+			if(prefix!=subtablePrefix){
+				//just big enough for the codes sharing this prefix, which (being canonical) are those that follow
+				unsigned bits = length-tableBits;
+				int left = 1<<bits;
+				for(unsigned l=length; l<maxLength; l++){
+					left -= counts[l];
+					if(left<=0) break;
+					bits++;
+					left <<= 1;
+				}
+
+				if(used+((size_t)1<<bits)>tableSize) return false;
+				subtablePrefix = prefix;
+				subtableStart = used;
+				subtableBits = bits;
+				used += (size_t)1<<bits;
+
+				if(!complete){
+					for(size_t index=subtableStart; index<used; index++) table[index] = invalid;
+				}
+				table[prefix] = _INFLATE_ENTRY(subtableStart, _INFLATE_SUBTABLE, bits)|tableBits;
+			}
+
+			for(size_t index=reversed>>tableBits; index<(size_t)1<<subtableBits; index+=(size_t)1<<(length-tableBits)){
+				table[subtableStart+index] = entry|(length-tableBits);
+			}
+		}
+
+		counts[length]--; //leaving those yet to be placed, for sizing subtables
+
+		//on to the next code (which, for longer ones, just gains zeros at the end)
+		unsigned bit = 1u<<(length-1);
+		while(reversed&bit) bit >>= 1;
+		reversed = (reversed&(bit-1))|bit;
+	}
+
+	return true;
+}
+
+// tops the bit buffer up to at least 56 bits, past the end of the input with zeros
+static inline void _inflate_refill(_Inflate *state) {
+	if(state->inEnd-state->in>=8){
+		uint64_t word;
+		memcpy(&word, state->in, 8);
+		#if __BYTE_ORDER__==__ORDER_BIG_ENDIAN__
+			word = __builtin_bswap64(word);
+		#endif
+		state->bits |= word<<state->bitCount;
+		state->in += (63-state->bitCount)>>3;
+		state->bitCount |= 56;
+		return;
+	}
+
+	for(; state->bitCount<=56; state->bitCount+=8){
+		if(state->in<state->inEnd){
+			state->bits |= (uint64_t)*state->in++<<state->bitCount;
+		}else{
+			state->overrun++;
+		}
+	}
+}
+
+static inline unsigned _inflate_take(_Inflate *state, unsigned count) {
+	unsigned value = state->bits&(((uint64_t)1<<count)-1);
+	state->bits >>= count;
+	state->bitCount -= count;
+	return value;
+}
+
+// whether more has been read than the input held
+static inline bool _inflate_overran(const _Inflate *state) {
+	return state->overrun*8>state->bitCount;
+}
+
+// looks up the next code in `table`, consuming it
+static inline uint32_t _inflate_decode(_Inflate *state, const uint32_t *table, unsigned tableBits) {
+	uint32_t entry = table[state->bits&((1u<<tableBits)-1)];
+	if((entry>>12&0xF)==_INFLATE_SUBTABLE){
+		_inflate_take(state, tableBits);
+		entry = table[(entry>>16)+(state->bits&((1u<<(entry>>8&0xF))-1))];
+	}
+
+	_inflate_take(state, entry&0xFF);
+	return entry;
+}
+
+// passes on the output so far, keeping the history matches may need
+static bool _inflate_flush(_Inflate *state) {
+	size_t length = state->out-state->flushed;
+	if(length>state->remaining) return false;
+	if(length && !state->put(state->flushed, length, state->data)) return false;
+	state->remaining -= length;
+
+	size_t keep = MIN((size_t)(state->out-state->window), INFLATE_WINDOW);
+	memmove(state->window, state->out-keep, keep);
+	state->out = state->flushed = state->window+keep;
+	return true;
+}
+
+static bool _inflate_stored(_Inflate *state) {
+	//back to the byte boundary, giving back whole bytes still in the bit buffer
+	_inflate_take(state, state->bitCount&7);
+	if(state->bitCount/8<state->overrun) return false;
+	state->in -= state->bitCount/8-state->overrun;
+	state->bits = 0;
+	state->bitCount = 0;
+	state->overrun = 0;
+
+	if(state->inEnd-state->in<4) return false;
+	size_t length = state->in[0]|state->in[1]<<8;
+	if((length^(state->in[2]|state->in[3]<<8))!=0xFFFF) return false;
+	state->in += 4;
+	if(state->inEnd-state->in<length) return false;
+
+	while(length){
+		if(state->out>state->limit && !_inflate_flush(state)) return false;
+
+		size_t count = MIN(length, (size_t)(state->windowEnd-state->out));
+		if(!count) return false; //more than it should have come to
+		memcpy(state->out, state->in, count);
+		state->out += count;
+		state->in += count;
+		length -= count;
+	}
+
+	return true;
+}
+
+// the fixed code's tables never change, so are built just once, by whichever thread first needs them (any others meanwhile build their own)
+static void _inflate_fixed_tables(_Inflate *state) {
+	static uint32_t literals[1<<9]; //as long as its codes get
+	static uint32_t distances[1<<5];
+	static int built = 0;           //then 1 while being built, and 2 once done
+
+	state->literalBits = 9;
+	state->distanceBits = 5;
+
+	if(__atomic_load_n(&built, __ATOMIC_ACQUIRE)==2){
+		state->literalTable = literals;
+		state->distanceTable = distances;
+		return;
+	}
+
+	int unbuilt = 0;
+	bool shared = __atomic_compare_exchange_n(&built, &unbuilt, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+	state->literalTable = shared?literals:state->literals;
+	state->distanceTable = shared?distances:state->distances;
+
+	uint8_t lengths[288];
+	memset(lengths, 8, 144);
+	memset(lengths+144, 9, 112);
+	memset(lengths+256, 7, 24);
+	memset(lengths+280, 8, 8);
+	_inflate_table((uint32_t*)state->literalTable, 1<<9, &state->literalBits, lengths, 288, _INFLATE_LITERALS);
+
+	memset(lengths, 5, 32);
+	_inflate_table((uint32_t*)state->distanceTable, 1<<5, &state->distanceBits, lengths, 32, _INFLATE_DISTANCES);
+
+	if(shared) __atomic_store_n(&built, 2, __ATOMIC_RELEASE);
+}
+
+static bool _inflate_dynamic_tables(_Inflate *state) {
+	static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+	_inflate_refill(state);
+	unsigned literalCount = _inflate_take(state, 5)+257;
+	unsigned distanceCount = _inflate_take(state, 5)+1;
+	unsigned codeCount = _inflate_take(state, 4)+4;
+	if(literalCount>286 || distanceCount>30) return false;
+
+	uint8_t codeLengths[19] = {0};
+	for(unsigned i=0; i<codeCount; i++){
+		_inflate_refill(state);
+		codeLengths[order[i]] = _inflate_take(state, 3);
+	}
+
+	uint32_t codes[1<<INFLATE_CODE_BITS];
+	unsigned codeBits = INFLATE_CODE_BITS;
+	if(!_inflate_table(codes, 1<<INFLATE_CODE_BITS, &codeBits, codeLengths, 19, _INFLATE_CODES)) return false;
+
+	//literal/length and distance code lengths, run-length encoded as one sequence
+	uint8_t lengths[286+30];
+	unsigned total = literalCount+distanceCount;
+	for(unsigned i=0; i<total;){
+		_inflate_refill(state);
+		if(_inflate_overran(state)) return false;
+
+		uint32_t entry = _inflate_decode(state, codes, codeBits);
+		if((entry>>12&0xF)!=_INFLATE_LITERAL) return false;
+
+		unsigned symbol = entry>>16;
+		if(symbol<16){
+			lengths[i++] = symbol;
+			continue;
+		}
+
+		uint8_t length = 0;
+		unsigned repeat;
+		if(symbol==16){
+			if(!i) return false;
+			length = lengths[i-1];
+			repeat = 3+_inflate_take(state, 2);
+		}else if(symbol==17){
+			repeat = 3+_inflate_take(state, 3);
+		}else{
+			repeat = 11+_inflate_take(state, 7);
+		}
+
+		if(repeat>total-i) return false;
+		memset(lengths+i, length, repeat);
+		i += repeat;
+	}
+
+	if(!lengths[256]) return false; //blocks have to end
+
+	state->literalTable = state->literals;
+	state->distanceTable = state->distances;
+	state->literalBits = INFLATE_LITERAL_BITS;
+	state->distanceBits = INFLATE_DISTANCE_BITS;
+	return _inflate_table(state->literals, INFLATE_LITERAL_TABLE, &state->literalBits, lengths, literalCount, _INFLATE_LITERALS) &&
+		_inflate_table(state->distances, INFLATE_DISTANCE_TABLE, &state->distanceBits, lengths+literalCount, distanceCount, _INFLATE_DISTANCES);
+}
+
+// decodes a block's codes, up to its end
+static bool _inflate_codes(_Inflate *state) {
+	const uint32_t *literals = state->literalTable;
+	const uint32_t *distances = state->distanceTable;
+	unsigned literalBits = state->literalBits;
+	unsigned distanceBits = state->distanceBits;
+	uint8_t *out = state->out;
+
+	while(true){
+		if(out>state->limit){
+			state->out = out;
+			if(!_inflate_flush(state)) return false;
+			out = state->out;
+		}
+
+		//56 bits are enough for a literal/length code with its extra bits (15+5), and a distance code with its own (15+13)
+		_inflate_refill(state);
+		if(_inflate_overran(state)) break;
+
+		uint32_t entry = _inflate_decode(state, literals, literalBits);
+		unsigned kind = entry>>12&0xF;
+
+		if(kind==_INFLATE_LITERAL){
+			*out++ = entry>>16;
+			continue;
+		}
+
+		if(kind!=_INFLATE_BASE){
+			if(kind!=_INFLATE_END) break;
+			state->out = out;
+			return !_inflate_overran(state);
+		}
+
+		size_t length = (entry>>16)+_inflate_take(state, entry>>8&0xF);
+
+		entry = _inflate_decode(state, distances, distanceBits);
+		if((entry>>12&0xF)!=_INFLATE_BASE) break;
+		size_t distance = (entry>>16)+_inflate_take(state, entry>>8&0xF);
+		if(distance>out-state->window) break;
+
+		const uint8_t *from = out-distance;
+		uint8_t *end = out+length;
+
+		if(distance>=8){
+			//a word at a time, running on into the margin
+			do{
+				memcpy(out, from, 8);
+				out += 8;
+				from += 8;
+			}while(out<end);
+		}else if(distance==1){
+			memset(out, *from, length);
+		}else{
+			do{
+				*out++ = *from++;
+			}while(out<end);
+		}
+
+		out = end;
+	}
+
+	state->out = out;
+	return false;
+}
+
+// inflates raw DEFLATE data that should come to exactly `size` bytes, passing it to `put` a chunk at a time
+bool inflate_buffer(const uint8_t *compressed, size_t compressedSize, uint64_t size, int (*put)(const void *buffer, int length, void *data), void *data) {
+	_Inflate *state = malloc(sizeof(_Inflate));
+	if(!state) return false;
+
+	size_t bufferSize = MIN(size, INFLATE_WINDOW+INFLATE_CHUNK)+INFLATE_MARGIN;
+	state->window = malloc(bufferSize);
+	if(!state->window){
+		free(state);
+		return false;
+	}
+
+	state->in = compressed;
+	state->inEnd = compressed+compressedSize;
+	state->bits = 0;
+	state->bitCount = 0;
+	state->overrun = 0;
+	state->windowEnd = state->window+bufferSize-INFLATE_MARGIN;
+	state->out = state->flushed = state->window;
+	state->limit = state->windowEnd-1;
+	state->remaining = size;
+	state->put = put;
+	state->data = data;
+
+	bool success = true;
+	for(bool final=false; success && !final;){
+		_inflate_refill(state);
+		final = _inflate_take(state, 1);
+
+		switch(_inflate_take(state, 2)){
+			case 0:
+				success = _inflate_stored(state);
+				break;
+			case 1:
+				_inflate_fixed_tables(state);
+				success = _inflate_codes(state);
+				break;
+			case 2:
+				success = _inflate_dynamic_tables(state) && _inflate_codes(state);
+				break;
+			default:
+				success = false;
+		}
+	}
+
+	success = success && !_inflate_overran(state) && _inflate_flush(state) && !state->remaining;
+
+	free(state->window);
+	free(state);
+
+	return success;
+}
+
+typedef void (*Archive_progress)(uint64_t bytes, void *data);
+
+typedef struct {
+	FILE *file;
+	char *buffer;
+	size_t length;
+	size_t size;
+	uint32_t crc32;
+	Sha256 *sha256;                   //also hashed into this, if set
+	Archive_progress on_progress;
+	void *progressData;
+} _Archive_output;
+
+static int _on_archive_output(const void *buffer, int length, void *userdata) {
+	_Archive_output *output = userdata;
+
+	output->crc32 = crc32_update(output->crc32, buffer, length);
+
+	if(output->sha256){
+		sha256_update(output->sha256, buffer, length);
+	}
+
+	if(output->on_progress){
+		output->on_progress(length, output->progressData);
+	}
+
+	if(output->buffer){
+		if(length>output->size-output->length) return 0;
+		memcpy(output->buffer+output->length, buffer, length);
+		output->length += length;
+		return 1;
+	}
+
+	if(!output->file) return 1; //only being checked
+
+	return fwrite(buffer, 1, length, output->file)==length;
+}
+
+static bool _archive_inflate(const Archive_entry *entry, const uint8_t *compressed, _Archive_output *output) {
+	if(entry->method==0){
+		return entry->compressedSize==entry->uncompressedSize && _on_archive_output(compressed, entry->compressedSize, output);
+	}
+
+	const char *backend = config_get("INFLATE");
+	if(backend && !strcmp(backend, "miniz")){
+		size_t compressedSize = entry->compressedSize;
+		return tinfl_decompress_mem_to_callback(compressed, &compressedSize, _on_archive_output, output, 0);
+	}
+
+	return inflate_buffer(compressed, entry->compressedSize, entry->uncompressedSize, _on_archive_output, output);
+}
+
+// the unix permissions (and file type) of `entry`, if it came from a unix system
+static uint32_t _archive_entry_mode(const Archive_entry *entry) {
+	return entry->madeBy>>8==3?entry->attributes>>16:0;
+}
+
+// symlinks are only made once everything else is extracted, so nothing is ever written through one
+static bool _archive_entry_link(const Archive_entry *entry) {
+	#ifdef _WIN32
+		return false; //written as files holding their target instead
+	#else
+		return (_archive_entry_mode(entry)&S_IFMT)==S_IFLNK;
+	#endif
+}
+
+static bool _archive_entry_directory(const Archive_entry *entry) {
+	size_t nameLength = strlen(entry->name);
+	return nameLength>0 && (entry->name[nameLength-1]=='/'||entry->name[nameLength-1]=='\\');
+}
+
+// returns where `entry` belongs within `path`, having created the directories leading to it, or NULL if it would escape `path`
+char *archive_entry_path(const Archive_entry *entry, const char *path) {
+	const char *name = entry->name;
+
+	{ //refuse anything that would escape the destination
+		if(name[0]=='/'||name[0]=='\\'||strchr(name, ':')) return NULL;
+
+		for(const char *c=name; *c; c++){
+			if((c==name||c[-1]=='/'||c[-1]=='\\') && c[0]=='.' && c[1]=='.' && (!c[2]||c[2]=='/'||c[2]=='\\')) return NULL;
+		}
+	}
+
+	char *filePath = malloc(strlen(path)+1+strlen(name)+1);
+	sprintf(filePath, "%s" PATH_SEPARATOR "%s", path, name);
+
+	#ifndef _WIN32
+		//nor anything reached through a symlink already made, which could lead anywhere
+		for(char *c=filePath+strlen(path)+1; *c; c++){
+			if(*c!='/') continue;
+
+			*c = '\0';
+			struct stat info;
+			bool linked = !lstat(filePath, &info) && S_ISLNK(info.st_mode);
+			*c = '/';
+
+			if(linked){
+				free(filePath);
+				return NULL;
+			}
+		}
+	#endif
+
+	bool created;
+
+	if(_archive_entry_directory(entry)){
+		created = make_path(filePath);
+
+	}else{ //create any parent directories not listed in the archive
+		char *separator = strrchr(filePath, '/');
+		#ifdef _WIN32
+			char *separator2 = strrchr(filePath, '\\');
+			if(separator2>separator) separator = separator2;
+		#endif
+
+		char separatorChar = *separator;
+		*separator = '\0';
+		created = make_path(filePath);
+		*separator = separatorChar;
+	}
+
+	if(!created){
+		free(filePath);
+		return NULL;
+	}
+
+	return filePath;
+}
+
+// extracts a single entry into `path`, given the archive `data` (which needs to hold at least the bytes of this entry)
+// `on_progress` (if set) is called with the number of bytes written as extraction proceeds
+bool archive_extract_entry(const Archive_entry *entry, const uint8_t *data, const char *path, Archive_progress on_progress, void *progressData) {
+	const char *name = entry->name;
+
+	char *filePath = archive_entry_path(entry, path);
+	if(!filePath){
+		fprintf(stderr, "Refusing to extract \"%s\" outside of \"%s\"\n", name, path);
+		return false;
+	}
+
+	bool success = false;
+
+	do{
+		if(_archive_entry_directory(entry)){
+			success = true;
+			break;
+		}
+
+		const uint8_t *header = data+entry->offset;
+		if(entry->offset+30>entry->end || _read32(header)!=0x04034b50) break;
+
+		uint64_t dataOffset = entry->offset+30+_read16(header+26)+_read16(header+28);
+		if(dataOffset+entry->compressedSize>entry->end) break;
+
+		const uint8_t *compressed = data+dataOffset;
+
+		if(entry->method!=0 && entry->method!=8){
+			fprintf(stderr, "Unsupported compression method %i for \"%s\"\n", entry->method, name);
+			break;
+		}
+
+		uint32_t mode = _archive_entry_mode(entry);
+
+		_Archive_output output = {
+			.crc32 = MZ_CRC32_INIT,
+			.on_progress = on_progress,
+			.progressData = progressData
+		};
+
+		Sha256 sha256;
+		bool shared = entry->uncompressedSize>=OBJECT_MINIMUM_SIZE;
+
+		#ifndef _WIN32
+			char target[PATH_MAX];
+
+			if((mode&S_IFMT)==S_IFLNK){
+				//symlinks store their target as the file content
+				output.buffer = target;
+				output.size = sizeof(target)-1;
+				shared = false;
+			}
+		#endif
+
+		if(shared){
+			uint8_t digest[32];
+			char *object = object_find(entry->crc32, entry->uncompressedSize, mode&0777, digest);
+
+			if(object){
+				//most likely a duplicate, so check it is without writing anything
+				sha256_init(&sha256);
+				output.sha256 = &sha256;
+
+				uint8_t entryDigest[32];
+				bool duplicate = _archive_inflate(entry, compressed, &output) && output.crc32==entry->crc32;
+				sha256_finish(&sha256, entryDigest);
+
+				duplicate = duplicate && !memcmp(digest, entryDigest, 32) && object_link(object, filePath);
+				free(object);
+
+				if(duplicate){
+					success = true;
+					break;
+				}
+
+				//otherwise extract it after all, without counting its progress twice
+				output.crc32 = MZ_CRC32_INIT;
+				output.on_progress = NULL;
+			}
+
+			sha256_init(&sha256);
+			output.sha256 = &sha256;
+		}
+
+		if(!output.buffer){
+			unlink(filePath);
+			output.file = fopen(filePath, "wb");
+			if(!output.file) break;
+			file_reserve(output.file, entry->uncompressedSize);
+		}
+
+		bool written = _archive_inflate(entry, compressed, &output);
+
+		if(output.file){
+			#ifndef _WIN32
+				if(mode&0777){
+					fchmod(fileno(output.file), mode&0777);
+				}
+			#endif
+			written = !fclose(output.file) && written;
+		}
+
+		if(!written||output.crc32!=entry->crc32){
+			fprintf(stderr, "Error extracting \"%s\"\n", name);
+			break;
+		}
+
+		#ifndef _WIN32
+			if(output.buffer){
+				target[output.length] = '\0';
+				unlink(filePath);
+				if(symlink(target, filePath)) break;
+			}
+		#endif
+
+		if(shared){
+			uint8_t digest[32];
+			sha256_finish(&sha256, digest);
+
+			object_store(filePath, entry->crc32, entry->uncompressedSize, mode&0777, digest);
+		}
+
+		success = true;
+	}while(false);
+
+	free(filePath);
+
+	return success;
+}
+
+#define EXTRACT_WORKERS_MAXIMUM 16
+
+unsigned cpu_count() {
+	#ifdef _WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return MAX(1, info.dwNumberOfProcessors);
+	#else
+		long count = sysconf(_SC_NPROCESSORS_ONLN);
+		return count>0?count:1;
+	#endif
+}
+
+// a pool of threads extracting entries from an archive as they are queued
+typedef struct {
+	const Archive *archive;
+	const uint8_t *data;
+	const char *path;
+
+	Thread workers[EXTRACT_WORKERS_MAXIMUM];
+	unsigned workerCount;
+
+	Mutex mutex;
+	Semaphore ready;   //posted once for each entry queued, and once per worker when finished or aborted
+	size_t *entries;   //indices of entries ready to be extracted, in the order they should be
+	size_t length;
+	size_t position;
+	size_t *links;     //symlink entries, set aside for once everything else is extracted
+	size_t linkCount;
+	unsigned running;  //workers still running
+	bool finished;     //nothing more will be queued
+	bool aborted;
+	bool failed;
+	uint64_t extracted;
+} _Extract_queue;
+
+static void _on_extract_queue_progress(uint64_t bytes, void *data) {
+	_Extract_queue *queue = data;
+
+	mutex_lock(&queue->mutex);
+		queue->extracted += bytes;
+	mutex_unlock(&queue->mutex);
+}
+
+static void *_extract_queue_main(void *arg) {
+	_Extract_queue *queue = arg;
+
+	while(true){
+		semaphore_wait(&queue->ready);
+
+		bool cancelled = ui_is_cancelled();
+
+		mutex_lock(&queue->mutex);
+			if(cancelled){
+				queue->aborted = true;
+			}
+
+			bool stop = queue->aborted || queue->failed || queue->finished&&queue->position>=queue->length;
+			bool available = !stop && queue->position<queue->length;
+			size_t index = available?queue->entries[queue->position++]:0;
+		mutex_unlock(&queue->mutex);
+
+		if(stop) break;
+		if(!available) continue;
+
+		if(_archive_entry_link(&queue->archive->entries[index])){
+			mutex_lock(&queue->mutex);
+				queue->links[queue->linkCount++] = index;
+			mutex_unlock(&queue->mutex);
+			continue;
+		}
+
+		if(!archive_extract_entry(&queue->archive->entries[index], queue->data, queue->path, _on_extract_queue_progress, queue)){
+			mutex_lock(&queue->mutex);
+				queue->failed = true;
+			mutex_unlock(&queue->mutex);
+		}
+	}
+
+	mutex_lock(&queue->mutex);
+		queue->running--;
+	mutex_unlock(&queue->mutex);
+
+	//wake the others, so they notice too
+	semaphore_post(&queue->ready, 1);
+
+	return NULL;
+}
+
+bool _extract_queue_init(_Extract_queue *queue, const Archive *archive, const uint8_t *data, const char *path, unsigned workerCount) {
+	memset(queue, 0, sizeof(*queue));
+
+	queue->archive = archive;
+	queue->data = data;
+	queue->path = path;
+	queue->entries = malloc((archive->entryCount+1)*sizeof(size_t));
+	queue->links = malloc((archive->entryCount+1)*sizeof(size_t));
+
+	mutex_init(&queue->mutex);
+	semaphore_init(&queue->ready);
+
+	workerCount = MAX(1, MIN(workerCount, EXTRACT_WORKERS_MAXIMUM));
+
+	for(unsigned i=0; i<workerCount; i++){
+		mutex_lock(&queue->mutex);
+			queue->running++;
+		mutex_unlock(&queue->mutex);
+
+		if(!thread_start(&queue->workers[queue->workerCount], _extract_queue_main, queue)){
+			mutex_lock(&queue->mutex);
+				queue->running--;
+			mutex_unlock(&queue->mutex);
+			break;
+		}
+
+		queue->workerCount++;
+	}
+
+	if(!queue->workerCount){
+		on_error("Error creating extraction thread");
+		mutex_free(&queue->mutex);
+		semaphore_free(&queue->ready);
+		free(queue->entries);
+		free(queue->links);
+		return false;
+	}
+
+	return true;
+}
+
+// queues `count` more entries for extraction
+void _extract_queue_push(_Extract_queue *queue, const size_t entries[], size_t count) {
+	mutex_lock(&queue->mutex);
+		memcpy(&queue->entries[queue->length], entries, count*sizeof(size_t));
+		queue->length += count;
+	mutex_unlock(&queue->mutex);
+
+	semaphore_post(&queue->ready, count);
+}
+
+// waits for the queue to be completed (or to stop early if `abort` is set), showing progress while it does
+// returns true if every queued entry was extracted
+bool _extract_queue_finish(_Extract_queue *queue, bool abort) {
+	mutex_lock(&queue->mutex);
+		if(abort){
+			queue->aborted = true;
+		}
+		queue->finished = true;
+	mutex_unlock(&queue->mutex);
+	semaphore_post(&queue->ready, 1);
+
+	uint64_t total = 0;
+	for(size_t i=0; i<queue->length; i++){
+		total += queue->archive->entries[queue->entries[i]].uncompressedSize;
+	}
+
+	while(true){
+		bool cancelled = ui_is_cancelled();
+
+		mutex_lock(&queue->mutex);
+			unsigned running = queue->running;
+			uint64_t extracted = queue->extracted;
+			if(cancelled){
+				queue->aborted = true;
+			}
+		mutex_unlock(&queue->mutex);
+
+		if(!running) break;
+
+		if(!abort){
+			ui_progress(MIN(extracted, total), total);
+		}
+
+		sleep_ms(1000/30);
+	}
+
+	for(unsigned i=0; i<queue->workerCount; i++){
+		thread_join(queue->workers[i]);
+	}
+
+	bool success = !queue->aborted && !queue->failed && queue->position==queue->length;
+
+	//only now that nothing else is being written
+	for(size_t i=0; success && i<queue->linkCount; i++){
+		success = archive_extract_entry(&queue->archive->entries[queue->links[i]], queue->data, queue->path, NULL, NULL);
+	}
+
+	mutex_free(&queue->mutex);
+	semaphore_free(&queue->ready);
+	free(queue->entries);
+	free(queue->links);
+
+	return success;
+}
+
+typedef struct {
+	uint64_t size;
+	size_t index;
+} _Extract_order;
+
+static int _extract_compare_size(const void *a, const void *b) {
+	const _Extract_order *orderA = a;
+	const _Extract_order *orderB = b;
+
+	return orderA->size>orderB->size?-1:orderA->size<orderB->size?1:0;
+}
+
+// extracts the zip archive held in `data` (described as `name`) into `path`, setting `size` to the total size of what was extracted
+bool extract_archive(const uint8_t *data, uint64_t length, const char *name, const char *path, uint64_t *size) {
+	ui_status("Extracting...");
+
+	Archive archive;
+	if(!archive_locate_directory(&archive, data, length, length) || !archive_read_directory(&archive, data+archive.directoryOffset)){
+		fprintf(stderr, "Unable to read the contents of %s\n", name);
+		archive_free(&archive);
+		return false;
+	}
+
+	*size = archive_uncompressed_size(&archive);
+
+	_Extract_queue queue;
+	bool success = _extract_queue_init(&queue, &archive, data, path, MIN(cpu_count(), archive.entryCount));
+
+	if(success){
+		//start with the largest entries, so a single huge file isn't left for last on one thread
+		_Extract_order *order = malloc((archive.entryCount+1)*sizeof(_Extract_order));
+		for(size_t i=0; i<archive.entryCount; i++){
+			order[i].size = archive.entries[i].uncompressedSize;
+			order[i].index = i;
+		}
+
+		qsort(order, archive.entryCount, sizeof(_Extract_order), _extract_compare_size);
+
+		size_t *entries = (size_t*)order; //reuse the same memory, as each index is read before it's overwritten
+		for(size_t i=0; i<archive.entryCount; i++){
+			entries[i] = order[i].index;
+		}
+
+		_extract_queue_push(&queue, entries, archive.entryCount);
+		free(order);
+
+		success = _extract_queue_finish(&queue, false);
+	}
+
+	archive_free(&archive);
+
+	return success;
+}
+
+// extracts zip archive `filename` into `path`, setting `size` to the total size of what was extracted
+bool extract_files(const char *filename, const char *path, uint64_t *size) {
+	Mapped_file mapped;
+	if(!map_file(filename, &mapped)) return false;
+
+	char *name = malloc(strlen(filename)+2+1);
+	sprintf(name, "\"%s\"", filename);
+
+	bool success = extract_archive(mapped.data, mapped.size, name, path, size);
+
+	free(name);
+	unmap_file(&mapped);
+
+	return success;
+}
+
+typedef struct {
+	char *buffer;
+	size_t length;
+	size_t size;
+} _Curl_buffer;
+
+static size_t _on_curl_write_memory(const char *ptr, size_t size, size_t nmemb, void *userdata) {
+	_Curl_buffer *buffer = userdata;
+
+	size_t chunkSize = size*nmemb;
+
+	if(buffer->length+chunkSize+1>=buffer->size){
+		//grow geometrically, so large bodies aren't copied over and over
+		buffer->size = MAX(buffer->size*2, buffer->length+chunkSize+1);
+
+		char *newBuffer = realloc(buffer->buffer, buffer->size);
+		if(!newBuffer){
+			fprintf(stderr, "Out of memory making web request\n");
+			return 0;
+		}
+
+		buffer->buffer = newBuffer;
+	}
+
+	memcpy(&buffer->buffer[buffer->length], ptr, chunkSize);
+
+	buffer->length += chunkSize;
+	buffer->buffer[buffer->length] = '\0';
+
+	return chunkSize;
+}
+
+// called for every chunk received, so it only leaves the progress for the window to sample, in the transfer's own share (`clientp`)
+// a transfer of unknown length (as when chunked or compressed) shows nothing until it knows
+static int _on_curl_progress(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow) {
+	if(dltotal>0){
+		ui_share_progress(clientp, dlnow, dltotal);
+	}
+
+	return ui_is_cancelled();
+}
+
+// returns a copy of the value of header `name` (including the colon), if that is the header in `buffer`
+char *http_header_value(const char *buffer, size_t length, const char *name) {
+	size_t nameLength = strlen(name);
+	if(length<=nameLength || strncasecmp(buffer, name, nameLength)) return NULL;
+
+	const char *value = buffer+nameLength;
+	const char *end = buffer+length;
+	while(value<end && *value==' ') value++;
+	while(end>value && (end[-1]=='\r'||end[-1]=='\n'||end[-1]==' ')) end--;
+
+	if(end<=value) return NULL;
+
+	char *copy = malloc(end-value+1);
+	memcpy(copy, value, end-value);
+	copy[end-value] = '\0';
+
+	return copy;
+}
+
+#define HTTP_CACHE_TIME (15*60) //default time (in seconds) cached responses are used without checking for changes
+#define HTTP_CACHE_CHUNK (64*1024) //size of the pieces cached bodies are read back in
+
+// responses from fetch_pages() are cached in the "http" cache folder, one file per url, named by its hash
+// each holds a few "name value" lines, a blank line, and then the body
+
+typedef struct {
+	char *etag;
+	char *lastModified;
+	char *link;        //the Link header, for paginated lists
+	time_t time;       //when this was last fetched or confirmed unchanged
+	long bodyOffset;   //where the body starts in the cache file
+} _Http_cache;
+
+// receives a body a piece at a time, as it arrives, returning false to abort
+// a call with no data means anything received so far should be discarded, as the body is starting over
+typedef bool (*Fetch_receiver)(void *page, const char *data, size_t length, void *userdata);
+
+char *_http_cache_filename(const char *url) {
+	char *filename = malloc(MAX_PATH+32);
+	get_user_cache_folder(filename, MAX_PATH, PROGRAM_NAME);
+	strcat(filename, "http" PATH_SEPARATOR);
+	#ifdef _WIN32
+		mkdir(filename);
+	#else
+		mkdir(filename, 0700);
+	#endif
+
+	sprintf(filename+strlen(filename), "%016" PRIx64, hash_string(url));
+
+	return filename;
+}
+
+void _http_cache_free(_Http_cache *cache) {
+	free(cache->etag);
+	free(cache->lastModified);
+	free(cache->link);
+	memset(cache, 0, sizeof(*cache));
+}
+
+// reads the details of the cached copy of `url`, if there is one
+bool _http_cache_read(const char *url, _Http_cache *cache) {
+	memset(cache, 0, sizeof(*cache));
+
+	char *filename = _http_cache_filename(url);
+	FILE *file = fopen(filename, "rb");
+	free(filename);
+
+	if(!file) return false;
+
+	bool valid = false;
+	char line[1024];
+
+	while(fgets(line, sizeof(line), file)){
+		line[strcspn(line, "\r\n")] = '\0';
+
+		if(!line[0]){
+			//the rest is the body
+			cache->bodyOffset = ftell(file);
+			valid = true;
+			break;
+
+		}else if(!strncmp(line, "url ", 4)){
+			if(strcmp(line+4, url)) break; //a hash collision
+
+		}else if(!strncmp(line, "etag ", 5)){
+			cache->etag = strdup(line+5);
+
+		}else if(!strncmp(line, "last-modified ", 14)){
+			cache->lastModified = strdup(line+14);
+
+		}else if(!strncmp(line, "link ", 5)){
+			cache->link = strdup(line+5);
+
+		}else if(!strncmp(line, "time ", 5)){
+			cache->time = strtoll(line+5, NULL, 10);
+		}
+	}
+
+	fclose(file);
+
+	if(!valid){
+		_http_cache_free(cache);
+	}
+
+	return valid;
+}
+
+// starts a new cached copy of `url` in `temporaryFilename` (to be freed by _http_cache_close(), which completes it)
+FILE *_http_cache_open(const char *url, const _Http_cache *cache, char **temporaryFilename) {
+	char *filename = _http_cache_filename(url);
+	*temporaryFilename = malloc(strlen(filename)+64);
+	sprintf(*temporaryFilename, "%s.%lld.%" PRIxPTR ".tmp", filename, (long long)getpid(), (uintptr_t)*temporaryFilename); //each writer's own, as several may write at once
+	free(filename);
+
+	FILE *file = fopen(*temporaryFilename, "wb");
+	if(!file){
+		free(*temporaryFilename);
+		*temporaryFilename = NULL;
+		return NULL;
+	}
+
+	fprintf(file, "url %s\n", url);
+	if(cache->etag) fprintf(file, "etag %s\n", cache->etag);
+	if(cache->lastModified) fprintf(file, "last-modified %s\n", cache->lastModified);
+	if(cache->link) fprintf(file, "link %s\n", cache->link);
+	fprintf(file, "time %lld\n", (long long)cache->time);
+	fprintf(file, "\n");
+
+	return file;
+}
+
+// finishes a copy started with _http_cache_open(), replacing the old one if `keep` is set (and it was all written)
+void _http_cache_close(const char *url, FILE *file, char *temporaryFilename, bool keep) {
+	char *filename = _http_cache_filename(url);
+
+	if(!fclose(file) && keep){
+		rename_replace(temporaryFilename, filename);
+	}else{
+		remove(temporaryFilename);
+	}
+
+	free(temporaryFilename);
+	free(filename);
+}
+
+// passes the cached body of `url` to `on_data`, rewriting the copy with the details in `update` along the way, if set
+bool _http_cache_replay(const char *url, const _Http_cache *cache, const _Http_cache *update, Fetch_receiver on_data, void *page, void *data) {
+	char *filename = _http_cache_filename(url);
+	FILE *file = fopen(filename, "rb");
+	free(filename);
+
+	if(!file || fseek(file, cache->bodyOffset, SEEK_SET)){
+		if(file) fclose(file);
+		return false;
+	}
+
+	char *copyFilename;
+	FILE *copy = update?_http_cache_open(url, update, &copyFilename):NULL;
+
+	char *buffer = malloc(HTTP_CACHE_CHUNK);
+	bool success = buffer!=NULL;
+
+	for(size_t length; success && (length = fread(buffer, 1, HTTP_CACHE_CHUNK, file));){
+		if(copy && fwrite(buffer, 1, length, copy)!=length){
+			_http_cache_close(url, copy, copyFilename, false);
+			copy = NULL;
+		}
+
+		success = on_data(page, buffer, length, data);
+	}
+
+	if(ferror(file)) success = false;
+
+	free(buffer);
+	fclose(file);
+
+	if(copy){
+		_http_cache_close(url, copy, copyFilename, success);
+	}
+
+	return success;
+}
+
+static size_t _on_curl_header_cache(char *buffer, size_t size, size_t nitems, void *userdata) {
+	_Http_cache *response = userdata;
+
+	size_t length = size*nitems;
+
+	//redirects send their own headers first, so only the last response counts
+	if(length>5 && !strncmp(buffer, "HTTP/", 5)){
+		_http_cache_free(response);
+	}
+
+	char *value;
+	if(value = http_header_value(buffer, length, "ETag:")){
+		free(response->etag);
+		response->etag = value;
+
+	}else if(value = http_header_value(buffer, length, "Last-Modified:")){
+		free(response->lastModified);
+		response->lastModified = value;
+
+	}else if(value = http_header_value(buffer, length, "Link:")){
+		free(response->link);
+		response->link = value;
+	}
+
+	return length;
+}
+
+// a single request made by fetch_pages(), split so several can share a curl multi handle
+typedef struct {
+	const char *url;
+	CURL *curl;           //NULL if no request is needed
+	struct curl_slist *headers;
+	_Http_cache cache;    //the cached copy, if any
+	bool cached;
+	_Http_cache response; //validators and links of the new response
+	Fetch_receiver on_data;
+	void *page;
+	void *data;
+	bool receiving;       //the body has started
+	FILE *store;          //the new cached copy, while a successful response is received
+	char *storeFilename;  //where it's written until complete
+	bool success;         //the body was received, once finished
+	char *link;           //the Link header that came with it
+	Ui_share progress;    //its share of the progress shown, while in progress
+} _Fetch;
+
+static size_t _on_curl_write_fetch(const char *ptr, size_t size, size_t nmemb, void *userdata) {
+	_Fetch *fetch = userdata;
+
+	size_t length = size*nmemb;
+
+	if(!fetch->receiving){
+		fetch->receiving = true;
+
+		long status = 0;
+		curl_easy_getinfo(fetch->curl, CURLINFO_RESPONSE_CODE, &status);
+
+		if(status>=200 && status<300){
+			fetch->response.time = time(NULL);
+			fetch->store = _http_cache_open(fetch->url, &fetch->response, &fetch->storeFilename);
+		}
+	}
+
+	if(fetch->store && fwrite(ptr, 1, length, fetch->store)!=length){
+		//caching is only a bonus, so carry on without it
+		_http_cache_close(fetch->url, fetch->store, fetch->storeFilename, false);
+		fetch->store = NULL;
+	}
+
+	if(!fetch->on_data(fetch->page, ptr, length, fetch->data)) return 0;
+
+	return length;
+}
+
+// prepares the request for `url`, passing the body to `on_data` as it arrives
+// cached copies younger than the CACHE_TIME setting (in seconds) are used without checking at all, in which case the body is passed on immediately
+bool _fetch_begin(_Fetch *fetch, const char *url, Fetch_receiver on_data, void *page, void *data) {
+	memset(fetch, 0, sizeof(*fetch));
+	fetch->url = url;
+	fetch->on_data = on_data;
+	fetch->page = page;
+	fetch->data = data;
+
+	fetch->cached = _http_cache_read(url, &fetch->cache);
+
+	time_t now = time(NULL);
+
+	if(fetch->cached && now>=fetch->cache.time && now-fetch->cache.time<config_get_number("CACHE_TIME", HTTP_CACHE_TIME)){
+		if(_http_cache_replay(url, &fetch->cache, NULL, on_data, page, data)){
+			fetch->success = true;
+			fetch->link = fetch->cache.link;
+			fetch->cache.link = NULL;
+			_http_cache_free(&fetch->cache);
+			return true;
+		}
+
+		//something went wrong with the copy, so fetch it afresh
+		on_data(page, NULL, 0, data);
+		_http_cache_free(&fetch->cache);
+		fetch->cached = false;
+	}
+
+	fetch->curl = curl_easy_init();
+	if(!fetch->curl){
+		on_error("Error initialising libcurl");
+		_http_cache_free(&fetch->cache);
+		return false;
+	}
+
+	if(fetch->cached){
+		char header[1024];
+		if(fetch->cache.etag){
+			snprintf(header, sizeof(header), "If-None-Match: %s", fetch->cache.etag);
+			fetch->headers = curl_slist_append(fetch->headers, header);
+		}
+		if(fetch->cache.lastModified){
+			snprintf(header, sizeof(header), "If-Modified-Since: %s", fetch->cache.lastModified);
+			fetch->headers = curl_slist_append(fetch->headers, header);
+		}
+	}
+
+	curl_easy_setopt(fetch->curl, CURLOPT_URL, url);
+	curl_easy_setopt(fetch->curl, CURLOPT_USERAGENT, PROGRAM_NAME "/" PROGRAM_VERSION);
+	curl_easy_setopt(fetch->curl, CURLOPT_FOLLOWLOCATION, true);
+	curl_easy_setopt(fetch->curl, CURLOPT_ACCEPT_ENCODING, ""); //anything curl can decode
+	curl_easy_setopt(fetch->curl, CURLOPT_HTTPHEADER, fetch->headers);
+	curl_easy_setopt(fetch->curl, CURLOPT_HEADERFUNCTION, _on_curl_header_cache);
+	curl_easy_setopt(fetch->curl, CURLOPT_HEADERDATA, &fetch->response);
+	curl_easy_setopt(fetch->curl, CURLOPT_WRITEFUNCTION, _on_curl_write_fetch);
+	curl_easy_setopt(fetch->curl, CURLOPT_WRITEDATA, fetch);
+	curl_easy_setopt(fetch->curl, CURLOPT_XFERINFOFUNCTION, _on_curl_progress);
+	curl_easy_setopt(fetch->curl, CURLOPT_XFERINFODATA, &fetch->progress);
+	curl_easy_setopt(fetch->curl, CURLOPT_NOPROGRESS, false);
+	curl_easy_setopt(fetch->curl, CURLOPT_PRIVATE, fetch);
+
+	return true;
+}
+
+// completes a request started with _fetch_begin(), once curl has finished with it
+void _fetch_end(_Fetch *fetch, CURLcode result) {
+	if(!fetch->curl) return;
+
+	ui_share_progress(&fetch->progress, 0, 0);
+
+	long status = 0;
+	curl_easy_getinfo(fetch->curl, CURLINFO_RESPONSE_CODE, &status);
+
+	if(result==CURLE_OK && status==304 && fetch->cached){
+		//unchanged, so keep what we have
+		_Http_cache *response = &fetch->response;
+		_Http_cache *cache = &fetch->cache;
+
+		_Http_cache update = {
+			.etag = response->etag?response->etag:cache->etag,
+			.lastModified = response->lastModified?response->lastModified:cache->lastModified,
+			.link = response->link?response->link:cache->link,
+			.time = time(NULL)
+		};
+
+		fetch->success = _http_cache_replay(fetch->url, cache, &update, fetch->on_data, fetch->page, fetch->data);
+		fetch->link = update.link?strdup(update.link):NULL;
+
+	}else if(result==CURLE_OK && status>=200 && status<300){
+		if(!fetch->receiving){
+			//an empty body
+			fetch->response.time = time(NULL);
+			fetch->store = _http_cache_open(fetch->url, &fetch->response, &fetch->storeFilename);
+		}
+
+		if(fetch->store){
+			_http_cache_close(fetch->url, fetch->store, fetch->storeFilename, true);
+			fetch->store = NULL;
+		}
+
+		fetch->success = true;
+		fetch->link = fetch->response.link;
+		fetch->response.link = NULL;
+
+	}else if(result!=CURLE_ABORTED_BY_CALLBACK && fetch->cached){
+		//better a stale list than none at all
+		fprintf(stderr, "Unable to refresh %s, using the cached copy instead\n", fetch->url);
+
+		fetch->on_data(fetch->page, NULL, 0, fetch->data);
+		fetch->success = _http_cache_replay(fetch->url, &fetch->cache, NULL, fetch->on_data, fetch->page, fetch->data);
+		fetch->link = fetch->cache.link;
+		fetch->cache.link = NULL;
+
+	}else if(result!=CURLE_OK){
+		if(result!=CURLE_ABORTED_BY_CALLBACK){
+			switch(result){
+				case CURLE_COULDNT_CONNECT:
+				case CURLE_COULDNT_RESOLVE_HOST:
+					on_error("Could not connect (%i)\nPlease ensure you have access to the internet", result);
+				break;
+				default:
+					on_error("Error retrieving %s\n%s", fetch->url, curl_easy_strerror(result));
+			}
+		}
+
+	}else{
+		//some other response, which is passed on as it is
+		fetch->success = true;
+	}
+
+	if(fetch->store){
+		_http_cache_close(fetch->url, fetch->store, fetch->storeFilename, false);
+		fetch->store = NULL;
+	}
+
+	curl_easy_cleanup(fetch->curl);
+	curl_slist_free_all(fetch->headers);
+	fetch->curl = NULL;
+	fetch->headers = NULL;
+	_http_cache_free(&fetch->response);
+	_http_cache_free(&fetch->cache);
+}
+
+// releases whatever is left of a request
+void _fetch_free(_Fetch *fetch) {
+	ui_share_progress(&fetch->progress, 0, 0);
+
+	if(fetch->curl){
+		if(fetch->store){
+			_http_cache_close(fetch->url, fetch->store, fetch->storeFilename, false);
+		}
+		curl_easy_cleanup(fetch->curl);
+		curl_slist_free_all(fetch->headers);
+		_http_cache_free(&fetch->response);
+		_http_cache_free(&fetch->cache);
+	}
+
+	free(fetch->link);
+	memset(fetch, 0, sizeof(*fetch));
+}
+
+#define FETCH_PAGES_PARALLEL 4 //maximum pages of a list requested at once
+
+// returns a copy of the url given for relation `rel` in a Link header, if present
+char *_http_link(const char *link, const char *rel) {
+	size_t relLength = strlen(rel);
+
+	for(const char *start; link && (start = strchr(link, '<'));){
+		const char *end = strchr(start, '>');
+		if(!end) break;
+
+		const char *next = strchr(end, ',');
+		const char *params = end+1;
+		const char *paramsEnd = next?next:params+strlen(params);
+
+		for(const char *param=params; param<paramsEnd && (param = strstr(param, "rel=")) && param<paramsEnd; param+=4){
+			const char *value = param+4;
+			if(*value=='"') value++;
+
+			if(paramsEnd-value>=relLength && !strncmp(value, rel, relLength) && (value[relLength]=='"'||value[relLength]==';'||value[relLength]==','||value[relLength]==' '||value[relLength]=='\0')){
+				char *url = malloc(end-start);
+				memcpy(url, start+1, end-start-1);
+				url[end-start-1] = '\0';
+				return url;
+			}
+		}
+
+		link = next;
+	}
+
+	return NULL;
+}
+
+// returns the position of the value of the "page" query parameter in `url`, if it has one
+const char *_http_page_parameter(const char *url) {
+	const char *query = strchr(url, '?');
+
+	for(const char *param=query; param; param=strchr(param+1, '&')){
+		if(!strncmp(param+1, "page=", 5)) return param+6;
+	}
+
+	return NULL;
+}
+
+// returns a copy of `url` requesting page `page` instead
+char *_http_page_url(const char *url, unsigned page) {
+	const char *value = _http_page_parameter(url);
+	if(!value) return NULL;
+
+	const char *valueEnd = value+strcspn(value, "&#");
+
+	char *pageUrl = malloc(strlen(url)+16);
+	sprintf(pageUrl, "%.*s%u%s", (int)(value-url), url, page, valueEnd);
+
+	return pageUrl;
+}
+
+// retrieves each page of the (GitHub style, Link paginated) list at `url`, streaming each body to `on_data` and then passing the page to `on_page`, in order, until it returns false
+// each page is given its own zeroed `pageSize` bytes of state to be parsed into, as once the number of pages is known several are requested at once
+// pages received past the point `on_page` stops are discarded
+bool fetch_pages(const char *url, Fetch_receiver on_data, size_t pageSize, bool (*on_page)(void *page, void *data), void *data) {
+	ui_status("Fetching update list...");
+
+	//pages are kept in a ring of FETCH_PAGES_PARALLEL slots
+	_Fetch fetches[FETCH_PAGES_PARALLEL] = {0};
+	char *pageUrls[FETCH_PAGES_PARALLEL] = {0};
+	bool pageDone[FETCH_PAGES_PARALLEL] = {0};
+	char *pages = calloc(FETCH_PAGES_PARALLEL, pageSize);
+
+	if(!pages){
+		on_error("Out of memory fetching %s", url);
+		return false;
+	}
+
+	if(!_fetch_begin(&fetches[0], url, on_data, pages, data)){
+		free(pages);
+		return false;
+	}
+
+	if(fetches[0].curl){
+		_fetch_end(&fetches[0], curl_easy_perform(fetches[0].curl));
+	}
+
+	if(!fetches[0].success){
+		_fetch_free(&fetches[0]);
+		free(pages);
+		return false;
+	}
+
+	if(!on_page(pages, data)){
+		_fetch_free(&fetches[0]);
+		free(pages);
+		return true;
+	}
+
+	char *nextUrl = _http_link(fetches[0].link, "next");
+	char *lastUrl = _http_link(fetches[0].link, "last");
+
+	_fetch_free(&fetches[0]);
+
+	unsigned nextPage = 0;
+	unsigned lastPage = 0;
+	if(nextUrl && lastUrl && _http_page_parameter(nextUrl) && _http_page_parameter(lastUrl)){
+		nextPage = strtoul(_http_page_parameter(nextUrl), NULL, 10);
+		lastPage = strtoul(_http_page_parameter(lastUrl), NULL, 10);
+	}
+	free(lastUrl);
+
+	bool success = true;
+
+	if(nextPage<1 || lastPage<nextPage || lastPage-nextPage>10000){
+		//without a page count to work from, just follow the links one page at a time
+		while(nextUrl && success){
+			memset(pages, 0, pageSize);
+
+			_Fetch *page = &fetches[0];
+			if(!_fetch_begin(page, nextUrl, on_data, pages, data)){
+				success = false;
+				break;
+			}
+
+			if(page->curl){
+				_fetch_end(page, curl_easy_perform(page->curl));
+			}
+
+			free(nextUrl);
+			nextUrl = NULL;
+
+			if(!page->success){
+				success = false;
+
+			}else if(on_page(pages, data)){
+				nextUrl = _http_link(page->link, "next");
+			}
+
+			_fetch_free(page);
+		}
+
+		free(nextUrl);
+		free(pages);
+		return success;
+	}
+
+	//pages run from nextPage to lastPage, with up to FETCH_PAGES_PARALLEL of them in flight, and are handed over strictly in order
+	unsigned pageCount = lastPage-nextPage+1;
+
+	CURLM *multi = curl_multi_init();
+	if(!multi){
+		on_error("Error initialising libcurl");
+		success = false;
+	}
+
+	unsigned started = 0;
+	unsigned delivered = 0;
+	bool finished = false;
+
+	while(success && !finished && delivered<pageCount){
+		for(; started<pageCount && started<delivered+FETCH_PAGES_PARALLEL; started++){
+			unsigned slot = started%FETCH_PAGES_PARALLEL;
+
+			memset(pages+slot*pageSize, 0, pageSize);
+			pageDone[slot] = false;
+			free(pageUrls[slot]);
+			pageUrls[slot] = _http_page_url(nextUrl, nextPage+started);
+
+			if(!_fetch_begin(&fetches[slot], pageUrls[slot], on_data, pages+slot*pageSize, data)){
+				success = false;
+				break;
+			}
+
+			if(fetches[slot].curl){
+				curl_multi_add_handle(multi, fetches[slot].curl);
+			}else{
+				pageDone[slot] = true;
+			}
+		}
+
+		for(; success && delivered<started && pageDone[delivered%FETCH_PAGES_PARALLEL]; delivered++){
+			unsigned slot = delivered%FETCH_PAGES_PARALLEL;
+
+			if(!fetches[slot].success){
+				success = false;
+
+			}else if(!on_page(pages+slot*pageSize, data)){
+				finished = true;
+			}
+
+			_fetch_free(&fetches[slot]);
+
+			if(finished){
+				delivered++;
+				break;
+			}
+		}
+
+		if(!success || finished || delivered>=pageCount) break;
+
+		int running;
+		if(curl_multi_perform(multi, &running)!=CURLM_OK){
+			on_error("Error retrieving %s", url);
+			success = false;
+			break;
+		}
+
+		CURLMsg *message;
+		int queued;
+		while(message = curl_multi_info_read(multi, &queued)){
+			if(message->msg!=CURLMSG_DONE) continue;
+
+			_Fetch *page;
+			curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char**)&page);
+
+			CURLcode result = message->data.result;
+
+			curl_multi_remove_handle(multi, page->curl);
+			_fetch_end(page, result);
+			pageDone[page-fetches] = true;
+		}
+
+		if(ui_is_cancelled()){
+			success = false;
+			break;
+		}
+
+		curl_multi_wait(multi, NULL, 0, 100, NULL);
+	}
+
+	for(unsigned i=0; i<FETCH_PAGES_PARALLEL; i++){
+		if(fetches[i].curl){
+			curl_multi_remove_handle(multi, fetches[i].curl);
+		}
+		_fetch_free(&fetches[i]);
+		free(pageUrls[i]);
+	}
+
+	if(multi) curl_multi_cleanup(multi);
+	free(pages);
+	free(nextUrl);
+
+	return success;
+}
+
+void _download_resume_remove(const char *filename);
+
+// downloads are hashed as they're written, so checking one against its published checksum takes no extra pass over it
+// bytes written just where the hash has got to are hashed as they go by, while any written further ahead (by other ranges, or an earlier attempt) are read back once it reaches them
+
+typedef struct {
+	Sha256 sha256;
+	const char *filename;
+	const uint8_t *data; //the file's contents, if it's held in memory instead
+	uint64_t size;      //of the whole file, or 0 if it's only ever written in order
+	uint64_t position;  //bytes hashed so far
+	FILE *file;         //for reading back what was written ahead, once needed
+} Download_digest;
+
+void download_digest_init(Download_digest *digest, const char *filename, uint64_t size) {
+	sha256_init(&digest->sha256);
+	digest->filename = filename;
+	digest->data = NULL;
+	digest->size = size;
+	digest->position = 0;
+	digest->file = NULL;
+}
+
+// hashes `length` bytes of `data` being written at `offset`, if they carry on from where the hash has got to
+static void _download_digest_feed(Download_digest *digest, uint64_t offset, const void *data, size_t length) {
+	if(offset>digest->position || offset+length<=digest->position) return;
+
+	size_t skip = digest->position-offset;
+	sha256_update(&digest->sha256, (const uint8_t*)data+skip, length-skip);
+	digest->position = offset+length;
+}
+
+typedef struct {
+	CURL *curl;
+	FILE *file;
+	_Curl_buffer *buffer; //written to instead of a file, if set
+	Download_digest *digest;
+	bool reserved;      //whether space has been reserved for the file, once its length was known
+} _Download_stream;
+
+static size_t _on_curl_write_stream(const char *ptr, size_t size, size_t nmemb, void *userdata) {
+	_Download_stream *stream = userdata;
+
+	if(!stream->reserved){
+		curl_off_t length;
+		if(curl_easy_getinfo(stream->curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length)==CURLE_OK && length>0){
+			if(stream->buffer){
+				char *buffer = (uint64_t)length<SIZE_MAX?realloc(stream->buffer->buffer, length+1):NULL;
+				if(buffer){
+					stream->buffer->buffer = buffer;
+					stream->buffer->size = MAX(stream->buffer->size, length+1);
+				}
+			}else{
+				file_reserve(stream->file, length);
+			}
+		}
+		stream->reserved = true;
+	}
+
+	size_t written = stream->buffer?_on_curl_write_memory(ptr, size, nmemb, stream->buffer):fwrite(ptr, size, nmemb, stream->file)*size;
+	if(stream->digest){
+		_download_digest_feed(stream->digest, stream->digest->position, ptr, written);
+	}
+
+	return written;
+}
+
+// downloads `url` in one go to `filename`, or if that's NULL, into `buffer`
+bool _download_single(const char *url, const char *filename, _Curl_buffer *buffer, Download_digest *digest) {
+	CURL *curl;
+	CURLcode res;
+ 
+	curl = curl_easy_init();
+	if(!curl){
+		on_error("Error initialising libcurl");
+		return false;
+	}
+
+	FILE *file = NULL;
+
+	if(filename){
+		//a single stream can't be resumed, so forget any partial download we had
+		_download_resume_remove(filename);
+
+		file = fopen(filename, "wb");
+		if(!file){
+			on_error("Unable to write to \"%s\"", filename);
+			return false;
+		}
+		setvbuf(file, NULL, _IOFBF, FILE_WRITE_BUFFER);
+	}
+
+	curl_easy_setopt(curl, CURLOPT_URL, url);
+	curl_easy_setopt(curl, CURLOPT_USERAGENT, PROGRAM_NAME "/" PROGRAM_VERSION);
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, true);
+	_Download_stream stream = {
+		.curl = curl,
+		.file = file,
+		.buffer = filename?NULL:buffer,
+		.digest = digest
+	};
+
+	Ui_share progress = {0};
+
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _on_curl_write_stream);
+	if(ui_enabled){
+		curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, _on_curl_progress);
+		curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &progress);
+	}
+	curl_easy_setopt(curl, CURLOPT_NOPROGRESS, false);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &stream);
+
+	CURLcode response = curl_easy_perform(curl);
+	ui_share_progress(&progress, 0, 0);
+
+	bool success = true;
+
+	if(response!=CURLE_OK){
+		if(response!=CURLE_ABORTED_BY_CALLBACK){
+			on_error("Error downloading \"%s\"\n  %s", url, curl_easy_strerror(response));
+		}
+
+		success = false;
+	}
+
+	curl_easy_cleanup(curl);
+
+	//what's still buffered is only written now, so this can fail too (when the disk is full, say)
+	if(file && fclose(file) && success){
+		on_error("Unable to write to \"%s\"", filename);
+		success = false;
+	}
+
+	return success;
+}
+
+#define DOWNLOAD_SEGMENTS        4
+#define DOWNLOAD_SEGMENT_MINIMUM (2*1024*1024)
+#define DOWNLOAD_RETRIES         3
+
+typedef struct {
+	char *url;          //final url, after any redirects
+	uint64_t size;      //total size, if known
+	uint64_t start;     //first byte of the range returned
+	bool ranges;        //true if the server honoured our Range request
+	char *validator;    //the ETag (or Last-Modified date) identifying this version of the file, for If-Range
+	CURL *curl;
+	_Curl_buffer *body; //receives the range returned, if set
+} _Download_probe;
+
+typedef struct {
+	CURL *curl;
+	FILE *file;
+	uint8_t *memory;   //the whole file, written to directly instead, if it's held in memory
+	uint64_t start;    //first byte of this range
+	uint64_t end;      //one past the last byte of this range
+	uint64_t position; //next byte to be written
+	unsigned retries;
+	bool responseChecked;
+	bool rangeIgnored; //the server replied with something other than our range
+	Download_digest *digest; //hashing the file as it's written, if set
+} _Download_segment;
+
+// reads back whatever is already written from where the hash has got to (everything but what `segments` have still to fetch)
+static bool _download_digest_catch_up(Download_digest *digest, const _Download_segment segments[], unsigned segmentCount) {
+	while(digest->position<digest->size){
+		//anything outside the segments is there already, and within one, up to where it's got to
+		uint64_t available = digest->size;
+		for(unsigned i=0; i<segmentCount; i++){
+			if(segments[i].start<=digest->position && digest->position<segments[i].end){
+				available = segments[i].position;
+				break;
+			}
+			if(segments[i].start>digest->position){
+				available = MIN(available, segments[i].start);
+			}
+		}
+
+		if(available<=digest->position) break;
+
+		if(digest->data){
+			sha256_update(&digest->sha256, digest->data+digest->position, available-digest->position);
+			digest->position = available;
+			continue;
+		}
+
+		if(!digest->file){
+			digest->file = fopen(digest->filename, "rb");
+			if(!digest->file) return false;
+
+			//unbuffered, so nothing is read ahead of what's been written
+			setvbuf(digest->file, NULL, _IONBF, 0);
+		}
+
+		uint8_t buffer[64*1024];
+		size_t length = MIN(sizeof(buffer), available-digest->position);
+		if(fseek(digest->file, digest->position, SEEK_SET) || fread(buffer, 1, length, digest->file)!=length) return false;
+
+		sha256_update(&digest->sha256, buffer, length);
+		digest->position += length;
+	}
+
+	return true;
+}
+
+void download_digest_free(Download_digest *digest) {
+	if(digest->file){
+		fclose(digest->file);
+		digest->file = NULL;
+	}
+}
+
+// finishes `digest`, returning whether the whole file matches the `expected` SHA-256 (reporting the error if not)
+bool download_digest_check(Download_digest *digest, const uint8_t expected[32]) {
+	bool read = _download_digest_catch_up(digest, NULL, 0);
+	download_digest_free(digest);
+
+	uint8_t actual[32];
+	sha256_finish(&digest->sha256, actual);
+
+	if(!read){
+		on_error("Unable to read \"%s\"", digest->filename);
+		return false;
+	}
+
+	if(memcmp(actual, expected, 32)){
+		on_error("The Electron archive is corrupt (it doesn't match its published checksum)");
+		return false;
+	}
+
+	return true;
+}
+
+// called each time around the transfer loop. Returning false aborts the download
+typedef bool (*_Download_update)(_Download_segment segments[], unsigned segmentCount, void *data);
+
+static size_t _on_curl_header_probe(char *buffer, size_t size, size_t nitems, void *userdata) {
+	_Download_probe *probe = userdata;
+
+	size_t length = size*nitems;
+
+	//redirects send their own headers first, so only the last response counts
+	if(length>5 && !strncmp(buffer, "HTTP/", 5)){
+		probe->size = 0;
+		probe->start = 0;
+		free(probe->validator);
+		probe->validator = NULL;
+	}
+
+	{ //a strong ETag is the best validator, although Last-Modified will do if that's all there is
+		char *value;
+		if(value = http_header_value(buffer, length, "ETag:")){
+			if(value[0]=='W' && value[1]=='/'){
+				free(value);
+			}else{
+				free(probe->validator);
+				probe->validator = value;
+			}
+
+		}else if(value = http_header_value(buffer, length, "Last-Modified:")){
+			if(!probe->validator){
+				probe->validator = value;
+			}else{
+				free(value);
+			}
+		}
+	}
+
+	if(length>14 && !strncasecmp(buffer, "Content-Range:", 14)){
+		//Content-Range: bytes 0-0/12345
+		const char *range = memchr(buffer, ' ', length);
+		const char *total = memchr(buffer, '/', length);
+		if(range && total && total[1]>='0' && total[1]<='9'){
+			while(*range==' ') range++;
+			if(!strncasecmp(range, "bytes ", 6)){
+				probe->start = strtoull(range+6, NULL, 10);
+			}
+			probe->size = strtoull(total+1, NULL, 10);
+		}
+	}
+
+	return length;
+}
+
+static size_t _on_curl_write_probe(const char *ptr, size_t size, size_t nmemb, void *userdata) {
+	_Download_probe *probe = userdata;
+
+	long status = 0;
+	curl_easy_getinfo(probe->curl, CURLINFO_RESPONSE_CODE, &status);
+	if(status!=206) return 0; //the server is sending the whole file, which is more than we asked for
+
+	if(!probe->body) return size*nmemb;
+
+	return _on_curl_write_memory(ptr, size, nmemb, probe->body);
+}
+
+// requests a single `range` of `url` to see whether ranges are supported, and how large the file is
+// the range returned is appended to `body`, if specified
+bool _download_probe(const char *url, const char *range, _Download_probe *probe, _Curl_buffer *body) {
+	probe->url = NULL;
+	probe->size = 0;
+	probe->start = 0;
+	probe->ranges = false;
+	probe->validator = NULL;
+	probe->body = body;
+
+	CURL *curl = curl_easy_init();
+	if(!curl) return false;
+
+	probe->curl = curl;
+
+	curl_easy_setopt(curl, CURLOPT_URL, url);
+	curl_easy_setopt(curl, CURLOPT_USERAGENT, PROGRAM_NAME "/" PROGRAM_VERSION);
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, true);
+	curl_easy_setopt(curl, CURLOPT_RANGE, range);
+	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, _on_curl_header_probe);
+	curl_easy_setopt(curl, CURLOPT_HEADERDATA, probe);
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _on_curl_write_probe);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, probe);
+
+	CURLcode response = curl_easy_perform(curl);
+
+	long status = 0;
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+
+	if(response==CURLE_OK||response==CURLE_WRITE_ERROR){
+		char *effectiveUrl = NULL;
+		curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &effectiveUrl);
+
+		probe->url = strdup(effectiveUrl?effectiveUrl:url);
+		probe->ranges = response==CURLE_OK && status==206 && probe->size>0;
+	}
+
+	curl_easy_cleanup(curl);
+
+	return probe->url!=NULL;
+}
+
+static size_t _on_curl_write_segment(const char *ptr, size_t size, size_t nmemb, void *userdata) {
+	_Download_segment *segment = userdata;
+
+	size_t length = size*nmemb;
+
+	if(!segment->responseChecked){
+		long status = 0;
+		curl_easy_getinfo(segment->curl, CURLINFO_RESPONSE_CODE, &status);
+		if(status!=206){
+			segment->rangeIgnored = true;
+			return 0;
+		}
+		segment->responseChecked = true;
+	}
+
+	if(length>segment->end-segment->position){
+		segment->rangeIgnored = true;
+		return 0;
+	}
+
+	if(segment->memory){
+		memcpy(segment->memory+segment->position, ptr, length);
+	}else if(fwrite(ptr, 1, length, segment->file)!=length){
+		return 0;
+	}
+
+	if(segment->digest){
+		_download_digest_feed(segment->digest, segment->position, ptr, length);
+	}
+
+	segment->position += length;
+
+	return length;
+}
+
+void _download_segment_request(_Download_segment *segment) {
+	char range[64];
+	sprintf(range, "%" PRIu64 "-%" PRIu64, segment->position, segment->end-1);
+
+	if(segment->file){
+		fseek(segment->file, segment->position, SEEK_SET);
+	}
+	segment->responseChecked = false;
+
+	curl_easy_setopt(segment->curl, CURLOPT_RANGE, range);
+}
+
+// creates `filename` at its full size, so ranges can be written into it at any offset
+bool _download_allocate(const char *filename, uint64_t size) {
+	FILE *file = fopen(filename, "wb");
+	if(!file){
+		on_error("Unable to write to \"%s\"", filename);
+		return false;
+	}
+
+	#ifdef _WIN32
+		bool allocated = !_chsize(_fileno(file), size);
+	#elif defined(__linux__)
+		bool allocated = !posix_fallocate(fileno(file), 0, size);
+	#else
+		bool allocated = !ftruncate(fileno(file), size);
+	#endif
+
+	fclose(file);
+
+	if(!allocated){
+		on_error("Unable to allocate %" PRIu64 " bytes for \"%s\"", size, filename);
+		return false;
+	}
+
+	return true;
+}
+
+#define DOWNLOAD_RESUME_INTERVAL 1000 //how often (in ms) progress is recorded for resuming later
+
+// a partially downloaded file is accompanied by a "<filename>.resume" record of which ranges are complete, so a later attempt can pick up where it left off
+
+typedef struct {
+	char *validator;
+	uint64_t size;
+	uint64_t (*ranges)[2]; //completed ranges, as start and end offsets
+	size_t rangeCount;
+} _Download_resume;
+
+char *_download_resume_filename(const char *filename) {
+	char *resumeFilename = malloc(strlen(filename)+7+1);
+	sprintf(resumeFilename, "%s.resume", filename);
+	return resumeFilename;
+}
+
+void _download_resume_remove(const char *filename) {
+	if(!filename) return; //held in memory, so never resumed
+
+	char *resumeFilename = _download_resume_filename(filename);
+	remove(resumeFilename);
+	free(resumeFilename);
+}
+
+bool _download_resume_read(const char *filename, _Download_resume *resume) {
+	resume->validator = NULL;
+	resume->size = 0;
+	resume->ranges = NULL;
+	resume->rangeCount = 0;
+
+	char *resumeFilename = _download_resume_filename(filename);
+	FILE *file = fopen(resumeFilename, "r");
+	free(resumeFilename);
+
+	if(!file) return false;
+
+	char line[1024];
+	while(fgets(line, sizeof(line), file)){
+		line[strcspn(line, "\r\n")] = '\0';
+
+		if(!strncmp(line, "size ", 5)){
+			resume->size = strtoull(line+5, NULL, 10);
+
+		}else if(!strncmp(line, "validator ", 10)){
+			free(resume->validator);
+			resume->validator = strdup(line+10);
+
+		}else if(!strncmp(line, "range ", 6)){
+			char *end;
+			uint64_t start = strtoull(line+6, &end, 10);
+			uint64_t stop = strtoull(end, NULL, 10);
+
+			if(stop>start){
+				resume->ranges = realloc(resume->ranges, (resume->rangeCount+1)*sizeof(*resume->ranges));
+				resume->ranges[resume->rangeCount][0] = start;
+				resume->ranges[resume->rangeCount][1] = stop;
+				resume->rangeCount++;
+			}
+		}
+	}
+
+	fclose(file);
+
+	return resume->validator && resume->size;
+}
+
+void _download_resume_free(_Download_resume *resume) {
+	free(resume->validator);
+	free(resume->ranges);
+}
+
+// records everything outside of the outstanding parts of `segments` as complete
+void _download_resume_write(const char *filename, const char *validator, uint64_t size, _Download_segment segments[], unsigned segmentCount) {
+	if(!validator || !filename) return;
+
+	char *resumeFilename = _download_resume_filename(filename);
+	char *temporaryFilename = malloc(strlen(resumeFilename)+4+1);
+	sprintf(temporaryFilename, "%s.tmp", resumeFilename);
+
+	FILE *file = fopen(temporaryFilename, "w");
+	if(file){
+		fprintf(file, "size %" PRIu64 "\n", size);
+		fprintf(file, "validator %s\n", validator);
+
+		//segments are in order, so the gaps between their outstanding parts are what we have
+		uint64_t position = 0;
+		for(unsigned i=0; i<segmentCount; i++){
+			if(segments[i].position>=segments[i].end) continue;
+
+			if(segments[i].position>position){
+				fprintf(file, "range %" PRIu64 " %" PRIu64 "\n", position, segments[i].position);
+			}
+			position = segments[i].end;
+		}
+		if(size>position){
+			fprintf(file, "range %" PRIu64 " %" PRIu64 "\n", position, size);
+		}
+
+		if(!fclose(file)){
+			rename_replace(temporaryFilename, resumeFilename);
+		}
+	}
+
+	free(temporaryFilename);
+	free(resumeFilename);
+}
+
+static int _download_compare_range(const void *a, const void *b) {
+	const uint64_t *rangeA = a;
+	const uint64_t *rangeB = b;
+
+	return rangeA[0]<rangeB[0]?-1:rangeA[0]>rangeB[0]?1:0;
+}
+
+// works out which ranges below `limit` still need fetching into `filename`, resuming any previous attempt at the same file
+// the file is created at its full size if nothing could be resumed. Returns the segments to fetch (possibly none), or NULL on error
+_Download_segment *_download_prepare(const char *filename, uint64_t size, const char *validator, uint64_t limit, unsigned *segmentCount) {
+	uint64_t (*missing)[2] = malloc((DOWNLOAD_SEGMENTS+1)*sizeof(*missing));
+	unsigned missingCount = 0;
+	unsigned missingSize = DOWNLOAD_SEGMENTS+1;
+
+	_Download_resume resume;
+	bool resumed = false;
+
+	if(filename && validator && _download_resume_read(filename, &resume) && resume.size==size && !strcmp(resume.validator, validator)){
+		struct stat info;
+		resumed = !stat(filename, &info) && info.st_size==size;
+	}
+
+	if(resumed){
+		qsort(resume.ranges, resume.rangeCount, sizeof(*resume.ranges), _download_compare_range);
+
+		uint64_t completed = 0;
+
+		uint64_t position = 0;
+		for(size_t i=0; i<=resume.rangeCount && position<limit; i++){
+			uint64_t start = i<resume.rangeCount?MIN(resume.ranges[i][0], limit):limit;
+			uint64_t end = i<resume.rangeCount?MIN(resume.ranges[i][1], limit):limit;
+
+			if(start>position){
+				if(missingCount>=missingSize){
+					missingSize *= 2;
+					missing = realloc(missing, missingSize*sizeof(*missing));
+				}
+				missing[missingCount][0] = position;
+				missing[missingCount][1] = start;
+				missingCount++;
+			}
+
+			completed += end>MAX(start, position)?end-MAX(start, position):0;
+			position = MAX(position, end);
+		}
+
+		printf("Resuming download (%" PRIu64 " of %" PRIu64 " bytes already present)\n", completed, limit);
+
+	}else{
+		_download_resume_remove(filename);
+
+		if(filename && !_download_allocate(filename, size)){
+			free(missing);
+			if(validator) _download_resume_free(&resume);
+			return NULL;
+		}
+
+		if(limit>0){
+			missing[0][0] = 0;
+			missing[0][1] = limit;
+			missingCount = 1;
+		}
+	}
+
+	if(filename && validator){
+		_download_resume_free(&resume);
+	}
+
+	//split the largest ranges until there's enough to keep several connections busy
+	while(missingCount<DOWNLOAD_SEGMENTS){
+		unsigned largest = 0;
+		for(unsigned i=1; i<missingCount; i++){
+			if(missing[i][1]-missing[i][0]>missing[largest][1]-missing[largest][0]) largest = i;
+		}
+
+		if(!missingCount || missing[largest][1]-missing[largest][0]<DOWNLOAD_SEGMENT_MINIMUM*2) break;
+
+		uint64_t middle = missing[largest][0]+(missing[largest][1]-missing[largest][0])/2;
+
+		if(missingCount>=missingSize){
+			missingSize *= 2;
+			missing = realloc(missing, missingSize*sizeof(*missing));
+		}
+		memmove(&missing[largest+2], &missing[largest+1], (missingCount-largest-1)*sizeof(*missing));
+		missing[largest+1][0] = middle;
+		missing[largest+1][1] = missing[largest][1];
+		missing[largest][1] = middle;
+		missingCount++;
+	}
+
+	_Download_segment *segments = calloc(missingCount+1, sizeof(_Download_segment));
+	for(unsigned i=0; i<missingCount; i++){
+		segments[i].start = missing[i][0];
+		segments[i].end = missing[i][1];
+		segments[i].position = segments[i].start;
+	}
+
+	free(missing);
+
+	*segmentCount = missingCount;
+	return segments;
+}
+
+// downloads the byte ranges described by `segments` from `url` into `filename` (which must already be allocated), or if that's NULL, into `memory`, all at once
+// progress is recorded alongside the file as it goes, so it can be resumed if interrupted, provided a `validator` is given to check against
+// returns false with `rangeIgnored` set if the server stopped honouring Range requests, in which case the caller should fall back to a single stream
+// if `digest` is set, the file is hashed as it's written
+bool _download_segments(const char *url, const char *filename, uint8_t *memory, uint64_t size, const char *validator, _Download_segment segments[], unsigned segmentCount, Download_digest *digest, _Download_update on_update, void *data, bool *rangeIgnored) {
+	*rangeIgnored = false;
+
+	CURLM *multi = curl_multi_init();
+
+	bool success = multi!=NULL;
+
+	//only accept ranges of the same version of the file as we already have
+	struct curl_slist *headers = NULL;
+	if(validator){
+		char *header = malloc(10+strlen(validator)+1);
+		sprintf(header, "If-Range: %s", validator);
+		headers = curl_slist_append(headers, header);
+		free(header);
+	}
+
+	unsigned long lastResumeTime = getTime();
+
+	for(unsigned i=0; success&&i<segmentCount; i++){
+		_Download_segment *segment = &segments[i];
+
+		segment->file = filename?fopen(filename, "r+b"):NULL;
+		segment->memory = filename?NULL:memory;
+		segment->curl = curl_easy_init();
+		segment->digest = digest;
+		if(!segment->file&&!segment->memory||!segment->curl){
+			success = false;
+			break;
+		}
+
+		//unbuffered, so anything written is immediately visible to readers of the file
+		if(segment->file){
+			setvbuf(segment->file, NULL, _IONBF, 0);
+		}
+
+		curl_easy_setopt(segment->curl, CURLOPT_URL, url);
+		curl_easy_setopt(segment->curl, CURLOPT_USERAGENT, PROGRAM_NAME "/" PROGRAM_VERSION);
+		curl_easy_setopt(segment->curl, CURLOPT_FOLLOWLOCATION, true);
+		curl_easy_setopt(segment->curl, CURLOPT_WRITEFUNCTION, _on_curl_write_segment);
+		curl_easy_setopt(segment->curl, CURLOPT_WRITEDATA, segment);
+		curl_easy_setopt(segment->curl, CURLOPT_PRIVATE, segment);
+		curl_easy_setopt(segment->curl, CURLOPT_HTTPHEADER, headers);
+
+		if(segment->position<segment->end){
+			_download_segment_request(segment);
+			curl_multi_add_handle(multi, segment->curl);
+		}
+	}
+
+	if(!success){
+		on_error("Error initialising download of \"%s\"", url);
+	}
+
+	unsigned remaining = 0;
+	for(unsigned i=0; i<segmentCount; i++){
+		if(segments[i].position<segments[i].end) remaining++;
+	}
+
+	while(success&&remaining>0){
+		int running;
+		if(curl_multi_perform(multi, &running)!=CURLM_OK){
+			on_error("Error downloading \"%s\"", url);
+			success = false;
+			break;
+		}
+
+		CURLMsg *message;
+		int queued;
+		while(success && (message = curl_multi_info_read(multi, &queued))){
+			if(message->msg!=CURLMSG_DONE) continue;
+
+			_Download_segment *segment;
+			curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char**)&segment);
+
+			CURLcode result = message->data.result;
+
+			curl_multi_remove_handle(multi, segment->curl);
+
+			if(segment->rangeIgnored){
+				*rangeIgnored = true;
+				success = false;
+
+			}else if(result==CURLE_OK && segment->position==segment->end){
+				remaining--;
+
+			}else if(segment->retries<DOWNLOAD_RETRIES){
+				//pick up again from wherever this segment got to
+				segment->retries++;
+				_download_segment_request(segment);
+				curl_multi_add_handle(multi, segment->curl);
+
+			}else{
+				on_error("Error downloading \"%s\"\n  %s", url, curl_easy_strerror(result!=CURLE_OK?result:CURLE_PARTIAL_FILE));
+				success = false;
+			}
+		}
+
+		if(!success) break;
+
+		uint64_t outstanding = 0;
+		for(unsigned i=0; i<segmentCount; i++){
+			outstanding += segments[i].end-segments[i].position;
+		}
+
+		//the segments are summed here, as one share
+		ui_progress(size-outstanding, size);
+
+		if(ui_is_cancelled() || on_update&&!on_update(segments, segmentCount, data)){
+			success = false;
+			break;
+		}
+
+		if(digest && !_download_digest_catch_up(digest, segments, segmentCount)){
+			on_error("Unable to read \"%s\"", filename);
+			success = false;
+			break;
+		}
+
+		unsigned long now = getTime();
+		if(now-lastResumeTime>=DOWNLOAD_RESUME_INTERVAL){
+			lastResumeTime = now;
+			_download_resume_write(filename, validator, size, segments, segmentCount);
+		}
+
+		if(remaining>0){
+			curl_multi_wait(multi, NULL, 0, 100, NULL);
+		}
+	}
+
+	for(unsigned i=0; i<segmentCount; i++){
+		if(segments[i].curl){
+			curl_multi_remove_handle(multi, segments[i].curl);
+			curl_easy_cleanup(segments[i].curl);
+			segments[i].curl = NULL;
+		}
+		if(segments[i].file){
+			fclose(segments[i].file);
+			segments[i].file = NULL;
+		}
+	}
+	curl_multi_cleanup(multi);
+	curl_slist_free_all(headers);
+
+	if(success || *rangeIgnored){
+		_download_resume_remove(filename);
+	}else{
+		_download_resume_write(filename, validator, size, segments, segmentCount);
+	}
+
+	return success;
+}
+
+// downloads `size` bytes from `url`, split into ranges fetched at once
+bool _download_segmented(const char *url, const char *filename, uint64_t size, const char *validator, Download_digest *digest, bool *rangeIgnored) {
+	*rangeIgnored = false;
+
+	unsigned segmentCount;
+	_Download_segment *segments = _download_prepare(filename, size, validator, size, &segmentCount);
+	if(!segments) return false;
+
+	bool success = _download_segments(url, filename, NULL, size, validator, segments, segmentCount, digest, NULL, NULL, rangeIgnored);
+
+	free(segments);
+
+	return success;
+}
+
+// checks a finished download against its `sha256`, removing it if it doesn't match (so none of it is resumed)
+static bool _download_check(Download_digest *digest, const uint8_t sha256[32]) {
+	if(download_digest_check(digest, sha256)) return true;
+
+	if(digest->filename){
+		remove(digest->filename);
+		_download_resume_remove(digest->filename);
+	}
+	return false;
+}
+
+// downloads `url` to `filename`, checking it against the `sha256` given (if any)
+bool download(const char *url, const char *filename, const uint8_t *sha256) {
+	ui_status("Downloading...");
+
+	Download_digest digest;
+
+	_Download_probe probe;
+	if(_download_probe(url, "0-0", &probe, NULL)){
+		if(probe.ranges && probe.size>=DOWNLOAD_SEGMENT_MINIMUM*2){
+			download_digest_init(&digest, filename, probe.size);
+
+			bool rangeIgnored;
+			bool success = _download_segmented(probe.url, filename, probe.size, probe.validator, sha256?&digest:NULL, &rangeIgnored);
+
+			if(success||!rangeIgnored){
+				free(probe.url);
+				free(probe.validator);
+
+				if(success && sha256) return _download_check(&digest, sha256);
+
+				download_digest_free(&digest);
+				return success;
+			}
+
+			download_digest_free(&digest);
+		}
+
+		free(probe.url);
+		free(probe.validator);
+	}
+
+	//the server doesn't support ranges (or the file is too small to bother), so just fetch it in one go
+	download_digest_init(&digest, filename, 0);
+	return _download_single(url, filename, NULL, sha256?&digest:NULL) && (!sha256 || _download_check(&digest, sha256));
+}
+
+// downloads `url` to `filename` (or into memory, if that's NULL) in full, then extracts it
+bool _download_then_extract(const char *url, const char *filename, const char *path, const uint8_t *sha256, uint64_t *size) {
+	bool extracted;
+
+	//what the archive holds isn't known until it's here, so downloading is taken as half the install
+	install_stage(0, 50);
+
+	if(filename){
+		if(!download(url, filename, sha256)) return false;
+
+		printf("Extracting...\n");
+		install_stage(50, 100);
+		extracted = extract_files(filename, path, size);
+
+	}else{
+		ui_status("Downloading...");
+
+		_Curl_buffer buffer = {0};
+		Download_digest digest;
+		download_digest_init(&digest, NULL, 0);
+
+		if(!_download_single(url, NULL, &buffer, sha256?&digest:NULL) || sha256 && !download_digest_check(&digest, sha256)){
+			free(buffer.buffer);
+			return false;
+		}
+
+		printf("Extracting...\n");
+		install_stage(50, 100);
+		extracted = extract_archive((uint8_t*)buffer.buffer, buffer.length, "the downloaded archive", path, size);
+		free(buffer.buffer);
+	}
+
+	if(!extracted){
+		if(!ui_is_cancelled()){
+			on_error("An error occurred extracting the downloaded Electron archive");
+		}
+		return false;
+	}
+
+	return true;
+}
+
+typedef struct {
+	_Extract_queue *queue;
+	size_t *nextEntry; //for each segment, the first of its entries not yet queued
+	size_t *lastEntry; //for each segment, one past the last of its entries
+} _Download_extract;
+
+static bool _on_download_extract_update(_Download_segment segments[], unsigned segmentCount, void *data) {
+	_Download_extract *state = data;
+	_Extract_queue *queue = state->queue;
+
+	for(unsigned i=0; i<segmentCount; i++){
+		//entries become available in order as each segment progresses, although larger ones may also need the segments following
+		while(state->nextEntry[i]<state->lastEntry[i]){
+			const Archive_entry *entry = &queue->archive->entries[state->nextEntry[i]];
+
+			bool available = true;
+			for(unsigned i2=i; available && i2<segmentCount && segments[i2].start<entry->end; i2++){
+				available = segments[i2].position>=MIN(entry->end, segments[i2].end);
+			}
+			if(!available) break;
+
+			_extract_queue_push(queue, &state->nextEntry[i], 1);
+			state->nextEntry[i]++;
+		}
+	}
+
+	mutex_lock(&queue->mutex);
+		bool failed = queue->failed;
+	mutex_unlock(&queue->mutex);
+
+	return !failed;
+}
+
+static int _hex_value(char c) {
+	return c>='0'&&c<='9'?c-'0':c>='a'&&c<='f'?c-'a'+10:c>='A'&&c<='F'?c-'A'+10:-1;
+}
+
+// returns the local path of a file:// `url`, or NULL if it's not one
+char *file_url_path(const char *url) {
+	if(strncasecmp(url, "file://", 7)) return NULL;
+
+	const char *path = url+7;
+	if(!strncasecmp(path, "localhost/", 10)) path += 9;
+
+	#ifdef _WIN32
+		//file:///C:/path
+		if(path[0]=='/' && path[1] && path[2]==':') path++;
+	#endif
+
+	char *decoded = malloc(strlen(path)+1);
+	char *end = decoded;
+
+	for(const char *c=path; *c; c++){
+		if(c[0]=='%' && _hex_value(c[1])>=0 && _hex_value(c[2])>=0){
+			*end++ = _hex_value(c[1])<<4|_hex_value(c[2]);
+			c += 2;
+		}else{
+			*end++ = *c;
+		}
+	}
+	*end = '\0';
+
+	return decoded;
+}
+
+// downloads a zip archive, extracting each entry into `path` as soon as its bytes have arrived, and setting `size` to the total extracted
+// the central directory is fetched first from the end of the file, so we know where each entry lies before the rest arrives
+// if `sha256` is set, the archive is checked against it as it arrives, and nothing extracted is kept unless it matches
+bool download_extract(const char *url, const char *filename, const char *path, const uint8_t *sha256, uint64_t *size) {
+	{ //local archives are extracted from where they are
+		char *localFilename = file_url_path(url);
+		if(localFilename){
+			struct stat info;
+			bool extracted = false;
+
+			if(stat(localFilename, &info)){
+				on_error("Unable to read \"%s\"", localFilename);
+
+			}else{
+				Download_digest digest;
+				download_digest_init(&digest, localFilename, info.st_size);
+
+				if(!sha256 || download_digest_check(&digest, sha256)){
+					printf("Extracting...\n");
+
+					extracted = extract_files(localFilename, path, size);
+					if(!extracted && !ui_is_cancelled()){
+						on_error("An error occurred extracting \"%s\"", localFilename);
+					}
+				}
+			}
+
+			free(localFilename);
+			return extracted;
+		}
+	}
+
+	ui_status("Downloading...");
+
+	Archive archive = {0};
+	_Download_probe probe = {0};
+
+	_Curl_buffer tail = {
+		.buffer = malloc(4096),
+		.length = 0,
+		.size = 4096
+	};
+
+	bool streamable = false;
+
+	{ //fetch the end of the archive, and see if it holds the whole central directory
+		char range[32];
+		sprintf(range, "-%u", ARCHIVE_TAIL_SIZE);
+
+		if(_download_probe(url, range, &probe, &tail) && probe.ranges && probe.start+tail.length==probe.size){
+			streamable = archive_locate_directory(&archive, (uint8_t*)tail.buffer, tail.length, probe.size);
+
+			if(streamable && archive.directoryOffset<probe.start){
+				//it didn't, so fetch again from the start of the directory
+				sprintf(range, "%" PRIu64 "-", archive.directoryOffset);
+
+				char *probeUrl = probe.url;
+				free(probe.validator);
+				tail.length = 0;
+				streamable = _download_probe(probeUrl, range, &probe, &tail) && probe.ranges && probe.start+tail.length==probe.size && probe.start==archive.directoryOffset;
+				free(probeUrl);
+			}
+
+			streamable = streamable && archive_read_directory(&archive, (uint8_t*)tail.buffer+(archive.directoryOffset-probe.start));
+		}
+	}
+
+	if(ui_is_cancelled()){
+		free(tail.buffer);
+		free(probe.url);
+		free(probe.validator);
+		archive_free(&archive);
+		return false;
+	}
+
+	if(!streamable){
+		free(tail.buffer);
+		free(probe.url);
+		free(probe.validator);
+		archive_free(&archive);
+
+		//we'll have to download it all first instead
+		return _download_then_extract(url, filename, path, sha256, size);
+	}
+
+	uint64_t tailStart = probe.start;
+
+	unsigned segmentCount;
+	_Download_segment *segments = _download_prepare(filename, probe.size, probe.validator, tailStart, &segmentCount);
+
+	Mapped_file mapped;
+	bool mappedAlready = false;
+
+	if(!filename && segments){
+		//held in memory instead, so there's nowhere else to write the tail
+		mappedAlready = map_anonymous(probe.size, &mapped);
+		if(!mappedAlready){
+			on_error("Not enough memory to download the Electron archive");
+			free(segments);
+			segments = NULL;
+		}else{
+			memcpy(mapped.data+tailStart, tail.buffer, tail.length);
+		}
+	}
+
+	{ //write out what we have of the tail already
+		bool written = mappedAlready;
+
+		if(filename){
+			FILE *file = segments?fopen(filename, "r+b"):NULL;
+			written = file && !fseek(file, tailStart, SEEK_SET) && fwrite(tail.buffer, 1, tail.length, file)==tail.length;
+			if(file){
+				written = !fclose(file) && written;
+			}
+		}
+
+		free(tail.buffer);
+
+		if(!written){
+			if(segments){
+				on_error("Unable to write to \"%s\"", filename);
+			}
+			free(segments);
+			free(probe.url);
+			free(probe.validator);
+			archive_free(&archive);
+			return false;
+		}
+	}
+
+	*size = archive_uncompressed_size(&archive);
+
+	//downloading and extracting make up the install in proportion to the bytes of each
+	int downloadShare = (int)(probe.size*100/MAX(1, probe.size+*size));
+	install_stage(0, downloadShare);
+
+	if(!mappedAlready && !map_file(filename, &mapped)){
+		on_error("Unable to read \"%s\"", filename);
+		free(segments);
+		free(probe.url);
+		free(probe.validator);
+		archive_free(&archive);
+		return false;
+	}
+
+	_Extract_queue queue;
+	bool success = _extract_queue_init(&queue, &archive, mapped.data, path, cpu_count());
+
+	Download_digest digest;
+	download_digest_init(&digest, filename, probe.size);
+	if(!filename) digest.data = mapped.data;
+	bool verified = true;
+
+	_Download_extract state = {
+		.queue = &queue,
+		.nextEntry = calloc(segmentCount, sizeof(size_t)),
+		.lastEntry = calloc(segmentCount, sizeof(size_t))
+	};
+
+	bool rangeIgnored = false;
+
+	if(success){
+		{ //note which entries end within (or before) each range still to come
+			size_t entry = 0;
+
+			for(unsigned i=0; i<segmentCount; i++){
+				state.nextEntry[i] = entry;
+				while(entry<archive.entryCount && archive.entries[entry].offset<segments[i].end) entry++;
+				state.lastEntry[i] = entry;
+			}
+
+			//anything after the last of these is here already
+			for(; entry<archive.entryCount; entry++){
+				_extract_queue_push(&queue, &entry, 1);
+			}
+		}
+
+		//queue anything we already have from a previous attempt
+		success = _on_download_extract_update(segments, segmentCount, &state);
+
+		success = success && _download_segments(probe.url, filename, filename?NULL:mapped.data, probe.size, probe.validator, segments, segmentCount, sha256?&digest:NULL, _on_download_extract_update, &state, &rangeIgnored);
+
+		//what's extracted is only kept (by the caller) if the archive matches
+		if(success && sha256){
+			success = verified = download_digest_check(&digest, sha256);
+		}
+
+		if(success){
+			//queue whatever is left
+			success = _on_download_extract_update(segments, segmentCount, &state);
+		}
+
+		if(success){
+			printf("Extracting...\n");
+			ui_status("Extracting...");
+			install_stage(downloadShare, 100);
+		}
+
+		success = _extract_queue_finish(&queue, !success) && success;
+
+		if(queue.failed){
+			on_error("An error occurred extracting the downloaded Electron archive");
+		}
+	}
+
+	unmap_file(&mapped);
+	download_digest_free(&digest);
+	free(state.nextEntry);
+	free(state.lastEntry);
+	free(segments);
+	free(probe.url);
+	free(probe.validator);
+	archive_free(&archive);
+
+	if(!verified && filename){
+		//none of it can be trusted, so nothing is resumed either
+		remove(filename);
+		_download_resume_remove(filename);
+	}
+
+	if(rangeIgnored && !ui_is_cancelled()){
+		//the server changed its mind about ranges part way through, so start over with a plain download
+		return _download_then_extract(url, filename, path, sha256, size);
+	}
+
+	return success;
+}
+
+#define JSON_ARENA_INITIAL 256 //tokens first allocated for parsing
+
+// tokens of the last document parsed. These are reused (and grown as needed) for every document, so each is only parsed once and nothing is allocated per document
+static jsmntok_t *_jsonArena = NULL;
+static int *_jsonArenaNext = NULL; //for each token, the index of the token following it and everything inside it
+static unsigned _jsonArenaSize = 0;
+
+// tokenises `dataLength` bytes of `data`, pointing `json` at the tokens. These belong to the arena, so remain valid only until the next call
+int json_init_length(jsmn_parser *jsonParser, jsmntok_t *json[], const char *data, size_t dataLength) {
+	*json = NULL;
+
+	jsmn_init(jsonParser);
+
+	while(true){
+		if(_jsonArenaSize){
+			int size = jsmn_parse(jsonParser, data, dataLength, _jsonArena, _jsonArenaSize);
+
+			if(size!=JSMN_ERROR_NOMEM){
+				if(size<=0) return 0;
+
+				//find where each subtree ends, so json_next() can jump straight past it
+				//tokens not yet ended form a stack, linked through their own entries until they're filled in
+				int open = -1;
+				for(int i=0; i<size; i++){
+					while(open>=0 && _jsonArena[i].start>_jsonArena[open].end){
+						int ended = open;
+						open = _jsonArenaNext[ended];
+						_jsonArenaNext[ended] = i;
+					}
+
+					_jsonArenaNext[i] = open;
+					open = i;
+				}
+				while(open>=0){
+					int ended = open;
+					open = _jsonArenaNext[ended];
+					_jsonArenaNext[ended] = size;
+				}
+
+				*json = _jsonArena;
+				return size;
+			}
+		}
+
+		//jsmn picks up where it left off, once given more room
+		unsigned newSize = _jsonArenaSize?_jsonArenaSize*2:JSON_ARENA_INITIAL;
+		jsmntok_t *newArena = realloc(_jsonArena, newSize*sizeof(jsmntok_t));
+		if(newArena) _jsonArena = newArena;
+
+		int *newArenaNext = realloc(_jsonArenaNext, newSize*sizeof(int));
+		if(newArenaNext) _jsonArenaNext = newArenaNext;
+
+		if(!newArena || !newArenaNext){
+			fprintf(stderr, "Out of memory parsing JSON\n");
+			return 0;
+		}
+
+		_jsonArenaSize = newSize;
+	}
+}
+
+// moves `position` on to the token after the current one, skipping anything inside it
+void json_next(jsmntok_t json[], int jsonLength, int *position) {
+	*position = *position<jsonLength?_jsonArenaNext[*position]:jsonLength;
+}
+
+// returns the position of the value with key `name` (of `nameLength` bytes) in object `parent`, or -1
+static int _json_query_key(jsmntok_t json[], int jsonLength, const char *data, int parent, const char *name, size_t nameLength) {
+	if(json[parent].type!=JSMN_OBJECT) return -1;
+
+	int end = _jsonArenaNext[parent];
+
+	//keys and values alternate, so step a pair at a time
+	for(int position=parent+1; position+1<end; position=_jsonArenaNext[position+1]){
+		if(json[position].end-json[position].start==nameLength && !memcmp(name, &data[json[position].start], nameLength)){
+			return position+1;
+		}
+	}
+
+	return -1;
+}
+
+// returns the position of the value found by following `path` from `parent`, or -1 if there's no such value of type `type`
+// path is a list of keys separated by '.', with numbers picking elements of arrays (such as "dependencies.electron" or "assets.0.name")
+int json_query(jsmntok_t json[], int jsonLength, const char *data, int parent, const char *path, jsmntype_t type) {
+	int position = parent;
+
+	while(position>=0 && position<jsonLength){
+		size_t length = strcspn(path, ".");
+
+		if(json[position].type==JSMN_ARRAY){
+			char *end;
+			unsigned long index = strtoul(path, &end, 10);
+			if(end!=path+length || !length) return -1;
+
+			int last = _jsonArenaNext[position];
+			position = position+1;
+			for(; index>0 && position<last; index--) position = _jsonArenaNext[position];
+			if(position>=last) return -1;
+
+		}else{
+			position = _json_query_key(json, jsonLength, data, position, path, length);
+		}
+
+		if(!path[length]) break;
+		path += length+1;
+	}
+
+	if(position<0 || position>=jsonLength) return -1;
+	if(json[position].type!=type && !(type==JSMN_STRING && json[position].type==JSMN_PRIMITIVE)) return -1;
+
+	return position;
+}
+
+// as json_query(), for a single key that may itself contain '.'
+int json_query_key(jsmntok_t json[], int jsonLength, const char *data, int parent, const char *name, jsmntype_t type) {
+	int position = _json_query_key(json, jsonLength, data, parent, name, strlen(name));
+
+	if(position<0) return -1;
+	if(json[position].type!=type && !(type==JSMN_STRING && json[position].type==JSMN_PRIMITIVE)) return -1;
+
+	return position;
+}
+
+#define JSON_STREAM_DEPTH 32            //maximum nesting of arrays and objects
+#define JSON_STREAM_KEY_MAXIMUM 64      //keys longer than this won't match anything
+#define JSON_STREAM_VALUE_MAXIMUM 1024  //strings longer than this are passed on truncated
+
+enum {
+	JSON_STREAM_VALUE,
+	JSON_STREAM_STRING,
+	JSON_STREAM_ESCAPE,
+	JSON_STREAM_UNICODE,
+	JSON_STREAM_PRIMITIVE
+};
+
+typedef struct Json_stream Json_stream;
+
+// a push parser, fed a document a piece at a time (such as when it arrives) so that it never needs to be held as a whole
+// only string values are passed on; depth and key say where they are (key being empty for array elements)
+struct Json_stream {
+	void (*on_open)(Json_stream *json, char type, void *data);  //type is '{' or '['. json->key names it, if inside an object
+	void (*on_close)(Json_stream *json, char type, void *data);
+	void (*on_string)(Json_stream *json, const char *value, size_t length, bool truncated, void *data);
+	void *data;
+
+	unsigned depth;
+	char stack[JSON_STREAM_DEPTH];
+	char root;         //type of the outermost value, once seen
+	bool error;
+
+	uint8_t state;
+	bool expectKey;
+	bool inKey;
+	unsigned unicodeDigits;
+	uint32_t unicode;
+	uint32_t surrogate;
+
+	char key[JSON_STREAM_KEY_MAXIMUM];
+	size_t keyLength;
+	bool keyTruncated;
+	char value[JSON_STREAM_VALUE_MAXIMUM];
+	size_t valueLength;
+	bool valueTruncated;
+};
+
+void json_stream_init(Json_stream *json, void (*on_open)(Json_stream*, char, void*), void (*on_close)(Json_stream*, char, void*), void (*on_string)(Json_stream*, const char*, size_t, bool, void*), void *data) {
+	memset(json, 0, sizeof(*json));
+	json->on_open = on_open;
+	json->on_close = on_close;
+	json->on_string = on_string;
+	json->data = data;
+}
+
+static void _json_stream_append(Json_stream *json, char c) {
+	if(json->inKey){
+		if(json->keyLength<JSON_STREAM_KEY_MAXIMUM-1){
+			json->key[json->keyLength++] = c;
+		}else{
+			json->keyTruncated = true;
+		}
+	}else{
+		if(json->valueLength<JSON_STREAM_VALUE_MAXIMUM-1){
+			json->value[json->valueLength++] = c;
+		}else{
+			json->valueTruncated = true;
+		}
+	}
+}
+
+static void _json_stream_append_span(Json_stream *json, const char *data, size_t length) {
+	char *buffer = json->inKey?json->key:json->value;
+	size_t *bufferLength = json->inKey?&json->keyLength:&json->valueLength;
+	size_t room = (json->inKey?JSON_STREAM_KEY_MAXIMUM:JSON_STREAM_VALUE_MAXIMUM)-1-*bufferLength;
+
+	if(length>room){
+		length = room;
+		if(json->inKey){
+			json->keyTruncated = true;
+		}else{
+			json->valueTruncated = true;
+		}
+	}
+
+	memcpy(buffer+*bufferLength, data, length);
+	*bufferLength += length;
+}
+
+static unsigned _count_trailing_zeros(uint64_t value) {
+	#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward64(&index, value);
+		return index;
+	#else
+		return __builtin_ctzll(value);
+	#endif
+}
+
+// returns how many bytes of `data` are plain string content, before the next quote, backslash or control character
+// most of a release list is long descriptions, so these are checked 16 bytes at a time where possible
+static size_t _json_string_span(const char *data, size_t length) {
+	size_t i = 0;
+
+	#if defined(SIMD_SSE2)
+		const __m128i quote = _mm_set1_epi8('"');
+		const __m128i backslash = _mm_set1_epi8('\\');
+		const __m128i control = _mm_set1_epi8(0x1F);
+
+		for(; i+16<=length; i+=16){
+			__m128i chunk = _mm_loadu_si128((const __m128i*)(data+i));
+			__m128i special = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+				_mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk) //chunk<=0x1F
+			);
+
+			unsigned mask = _mm_movemask_epi8(special);
+			if(mask) return i+_count_trailing_zeros(mask);
+		}
+
+	#elif defined(SIMD_NEON)
+		const uint8x16_t quote = vdupq_n_u8('"');
+		const uint8x16_t backslash = vdupq_n_u8('\\');
+		const uint8x16_t control = vdupq_n_u8(0x1F);
+
+		for(; i+16<=length; i+=16){
+			uint8x16_t chunk = vld1q_u8((const uint8_t*)(data+i));
+			uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)), vcleq_u8(chunk, control));
+
+			//narrow each byte to 4 bits, so the whole lot fits in 64
+			uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(special), 4)), 0);
+			if(mask) return i+_count_trailing_zeros(mask)/4;
+		}
+	#endif
+
+	for(; i<length; i++){
+		if(data[i]=='"' || data[i]=='\\' || (uint8_t)data[i]<0x20) break;
+	}
+
+	return i;
+}
+
+static void _json_stream_append_codepoint(Json_stream *json, uint32_t c) {
+	if(c<0x80){
+		_json_stream_append(json, c);
+	}else if(c<0x800){
+		_json_stream_append(json, 0xC0|c>>6);
+		_json_stream_append(json, 0x80|c&0x3F);
+	}else if(c<0x10000){
+		_json_stream_append(json, 0xE0|c>>12);
+		_json_stream_append(json, 0x80|c>>6&0x3F);
+		_json_stream_append(json, 0x80|c&0x3F);
+	}else{
+		_json_stream_append(json, 0xF0|c>>18);
+		_json_stream_append(json, 0x80|c>>12&0x3F);
+		_json_stream_append(json, 0x80|c>>6&0x3F);
+		_json_stream_append(json, 0x80|c&0x3F);
+	}
+}
+
+// parses the next `length` bytes of the document, returning false if it isn't valid
+bool json_stream_feed(Json_stream *json, const char *data, size_t length) {
+	for(size_t i=0; i<length && !json->error; i++){
+		char c = data[i];
+
+		switch(json->state){
+			case JSON_STREAM_STRING: {
+				size_t span = _json_string_span(data+i, length-i);
+				if(span){
+					_json_stream_append_span(json, data+i, span);
+					i += span-1;
+					break;
+				}
+
+				if(c=='"'){
+					json->state = JSON_STREAM_VALUE;
+
+					if(json->inKey){
+						if(json->keyTruncated) json->keyLength = 0;
+						json->key[json->keyLength] = '\0';
+						json->inKey = false;
+						json->expectKey = false;
+
+					}else{
+						if(!json->depth && !json->root) json->root = '"';
+						json->value[json->valueLength] = '\0';
+						if(json->on_string) json->on_string(json, json->value, json->valueLength, json->valueTruncated, json->data);
+					}
+
+				}else if(c=='\\'){
+					json->state = JSON_STREAM_ESCAPE;
+
+				}else{
+					//a control character, which must be escaped
+					json->error = true;
+				}
+			} break;
+			case JSON_STREAM_ESCAPE:
+				json->state = JSON_STREAM_STRING;
+
+				switch(c){
+					case '"':
+					case '\\':
+					case '/':
+						_json_stream_append(json, c);
+					break;
+					case 'b': _json_stream_append(json, '\b'); break;
+					case 'f': _json_stream_append(json, '\f'); break;
+					case 'n': _json_stream_append(json, '\n'); break;
+					case 'r': _json_stream_append(json, '\r'); break;
+					case 't': _json_stream_append(json, '\t'); break;
+					case 'u':
+						json->state = JSON_STREAM_UNICODE;
+						json->unicode = 0;
+						json->unicodeDigits = 0;
+					break;
+					default:
+						json->error = true;
+				}
+			break;
+			case JSON_STREAM_UNICODE:
+				if(c>='0'&&c<='9'){
+					json->unicode = json->unicode<<4|c-'0';
+				}else if(c>='a'&&c<='f'){
+					json->unicode = json->unicode<<4|c-'a'+10;
+				}else if(c>='A'&&c<='F'){
+					json->unicode = json->unicode<<4|c-'A'+10;
+				}else{
+					json->error = true;
+					break;
+				}
+
+				if(++json->unicodeDigits==4){
+					json->state = JSON_STREAM_STRING;
+
+					if(json->unicode>=0xD800 && json->unicode<0xDC00){
+						//the first half of a surrogate pair
+						json->surrogate = json->unicode;
+
+					}else if(json->unicode>=0xDC00 && json->unicode<0xE000 && json->surrogate){
+						_json_stream_append_codepoint(json, 0x10000+((json->surrogate-0xD800)<<10)+(json->unicode-0xDC00));
+						json->surrogate = 0;
+
+					}else{
+						_json_stream_append_codepoint(json, json->unicode);
+						json->surrogate = 0;
+					}
+				}
+			break;
+			case JSON_STREAM_PRIMITIVE:
+				if(c>='a'&&c<='z' || c>='0'&&c<='9' || c=='.' || c=='-' || c=='+' || c=='E') break;
+
+				//the end of it, so handle this character as normal
+				json->state = JSON_STREAM_VALUE;
+				i--;
+			break;
+			case JSON_STREAM_VALUE:
+				switch(c){
+					case ' ':
+					case '\t':
+					case '\r':
+					case '\n':
+					break;
+					case '{':
+					case '[':
+						if(json->expectKey || json->depth>=JSON_STREAM_DEPTH || !json->depth && json->root){
+							json->error = true;
+							break;
+						}
+
+						if(!json->depth) json->root = c;
+						json->stack[json->depth++] = c;
+
+						if(json->on_open) json->on_open(json, c, json->data);
+
+						json->expectKey = c=='{';
+						json->key[0] = '\0';
+						json->keyLength = 0;
+					break;
+					case '}':
+					case ']':
+						if(!json->depth || json->stack[json->depth-1]!=(c=='}'?'{':'[')){
+							json->error = true;
+							break;
+						}
+
+						json->depth--;
+						json->expectKey = false;
+						json->key[0] = '\0';
+						json->keyLength = 0;
+
+						if(json->on_close) json->on_close(json, c=='}'?'{':'[', json->data);
+					break;
+					case ',':
+						if(!json->depth){
+							json->error = true;
+							break;
+						}
+
+						json->expectKey = json->stack[json->depth-1]=='{';
+					break;
+					case ':':
+						if(!json->depth || json->stack[json->depth-1]!='{'){
+							json->error = true;
+						}
+					break;
+					case '"':
+						if(!json->depth && json->root){
+							json->error = true;
+							break;
+						}
+
+						json->state = JSON_STREAM_STRING;
+						json->inKey = json->expectKey;
+						json->surrogate = 0;
+
+						if(json->inKey){
+							json->keyLength = 0;
+							json->keyTruncated = false;
+						}else{
+							json->valueLength = 0;
+							json->valueTruncated = false;
+						}
+					break;
+					default:
+						if(json->expectKey || !json->depth && json->root){
+							json->error = true;
+							break;
+						}
+
+						if(!json->depth) json->root = 'p';
+						json->state = JSON_STREAM_PRIMITIVE;
+				}
+			break;
+		}
+	}
+
+	return !json->error;
+}
+
+// returns whether the document fed in was complete and valid
+bool json_stream_finish(Json_stream *json) {
+	return !json->error && json->root && !json->depth && (json->state==JSON_STREAM_VALUE || json->state==JSON_STREAM_PRIMITIVE);
+}
+
+void read_electron_requirement(char **requirement, const char *data, size_t dataLength) {
+	jsmn_parser jsonParser;
+	jsmntok_t *json;
+
+	*requirement = NULL;
+
+	int parsed = json_init_length(&jsonParser, &json, data, dataLength);
+
+	if(!json||parsed<1||json[0].type!=JSMN_OBJECT){
+		fprintf(stderr, "Error parsing package.json\n");
+		return;
+	}
+
+	//later entries take precedence
+	const char *paths[] = {
+		"dependencies.electron-prebuilt",
+		"dependencies.electron",
+		"devDependencies.electron-prebuilt",
+		"devDependencies.electron"
+	};
+
+	int electronPosition = -1;
+
+	for(unsigned i=0; i<sizeof(paths)/sizeof(paths[0]); i++){
+		int position = json_query(json, parsed, data, 0, paths[i], JSMN_STRING);
+		if(position>=0){
+			electronPosition = position;
+		}
+	}
+
+	if(electronPosition>=0){
+		//data may well be a read-only view, so copy the value out rather than terminating it in place
+		size_t length = json[electronPosition].end-json[electronPosition].start;
+		*requirement = malloc(length+1);
+		memcpy(*requirement, &data[json[electronPosition].start], length);
+		(*requirement)[length] = '\0';
+	}else{
+		*requirement = strdup(">=1.0");
+	}
+}
+
+// what a project requires, as read from its package.json
+typedef struct {
+	char *path;            //the project folder, or archive (which may have gained ".asar")
+	char *packagePath;     //package.json, or the archive holding it
+	uint64_t packageHash;
+	char *requirement;     //NULL if package.json couldn't be parsed
+} Project;
+
+void project_free(Project *project) {
+	free(project->path);
+	free(project->packagePath);
+	free(project->requirement);
+	memset(project, 0, sizeof(*project));
+}
+
+// strips any trailing slashes from `path`, as projects are named without them
+void strip_trailing_separators(char *path) {
+	size_t length = strlen(path);
+	while(length>0 && (path[length-1]=='/'||path[length-1]=='\\')){
+		path[--length] = '\0';
+	}
+}
+
+// reads the project at `path`, or failing that "<path>.asar", returning 0 or the error reading its package.json
+int project_read(Project *project, const char *path) {
+	memset(project, 0, sizeof(*project));
+	project->path = strdup(path);
+
+	File_view projectFile;
+	int error = read_file(project->path, "package.json", &projectFile);
+
+	if(error==ENOENT){
+		char *archivePath = malloc(strlen(path)+5+1);
+		sprintf(archivePath, "%s.asar", path);
+
+		error = read_file(archivePath, "package.json", &projectFile);
+		if(error!=ENOENT){
+			free(project->path);
+			project->path = archivePath;
+		}else{
+			free(archivePath);
+		}
+	}
+
+	if(error) return error;
+
+	read_electron_requirement(&project->requirement, projectFile.data, projectFile.size);
+
+	project->packagePath = project_package_path(project->path);
+	project->packageHash = hash_bytes(projectFile.data, projectFile.size);
+
+	file_view_free(&projectFile);
+
+	return 0;
+}
+
+// releases come from an ordered list of mirrors, set by MIRRORS, each tried in turn until one has what's needed
+// each is a base url (file:// urls included), or "github" for GitHub itself, which is the only one by default
+// the release list (in the format of the GitHub API) is read from the base plus the MIRROR_CATALOG template, and archives from the base plus the MIRROR_ASSET template
+// within templates {version}, {tag} and {file} are replaced by the version (28.1.0), its tag (v28.1.0) and the archive name (electron-v28.1.0-linux-x64.zip)
+
+#define MIRROR_GITHUB "github"
+#define MIRROR_GITHUB_CATALOG "https://api.github.com/repos/electron/electron/releases?per_page=100"
+#define MIRROR_CATALOG_DEFAULT "releases.json"
+#define MIRROR_ASSET_DEFAULT "{version}/{file}" //the layout of npm's Electron mirrors
+
+typedef struct {
+	char **mirrors;
+	unsigned count;
+} Mirror_list;
+
+void mirror_list_read(Mirror_list *list) {
+	list->mirrors = NULL;
+	list->count = 0;
+
+	const char *value = config_get("MIRRORS");
+	if(!value) value = MIRROR_GITHUB;
+
+	const char *separators = " \t,;";
+
+	for(const char *mirror=value+strspn(value, separators); *mirror; mirror+=strspn(mirror, separators)){
+		size_t length = strcspn(mirror, separators);
+
+		list->mirrors = realloc(list->mirrors, (list->count+1)*sizeof(char*));
+		list->mirrors[list->count] = malloc(length+1);
+		memcpy(list->mirrors[list->count], mirror, length);
+		list->mirrors[list->count][length] = '\0';
+		list->count++;
+
+		mirror += length;
+	}
+}
+
+void mirror_list_free(Mirror_list *list) {
+	for(unsigned i=0; i<list->count; i++){
+		free(list->mirrors[i]);
+	}
+	free(list->mirrors);
+	list->mirrors = NULL;
+	list->count = 0;
+}
+
+// returns the url of `template` on `mirror`, for `version` (if any)
+char *mirror_url(const char *mirror, const char *template, const char *version) {
+	char file[128] = "";
+	if(version){
+		snprintf(file, sizeof(file), "electron-v%s-" BUILDARCHSTRING ".zip", version);
+	}
+
+	size_t mirrorLength = strlen(mirror);
+	bool separated = mirrorLength>0 && mirror[mirrorLength-1]=='/';
+
+	char *url = malloc(mirrorLength+1+strlen(template)*(version?sizeof(file):1)+1);
+	sprintf(url, "%s%s", mirror, separated?"":"/");
+
+	char *end = url+strlen(url);
+	for(const char *c=template; *c;){
+		if(version && !strncmp(c, "{version}", 9)){
+			end += sprintf(end, "%s", version);
+			c += 9;
+		}else if(version && !strncmp(c, "{tag}", 5)){
+			end += sprintf(end, "v%s", version);
+			c += 5;
+		}else if(version && !strncmp(c, "{file}", 6)){
+			end += sprintf(end, "%s", file);
+			c += 6;
+		}else{
+			*end++ = *c++;
+		}
+	}
+	*end = '\0';
+
+	return url;
+}
+
+// fetches the whole of `url` into `body`, returning the (unreported) result, and setting `status` to the HTTP status received (or 0 if none)
+CURLcode fetch_buffer(const char *url, _Curl_buffer *body, long *status) {
+	*status = 0;
+
+	CURL *curl = curl_easy_init();
+	if(!curl) return CURLE_FAILED_INIT;
+
+	curl_easy_setopt(curl, CURLOPT_URL, url);
+	curl_easy_setopt(curl, CURLOPT_USERAGENT, PROGRAM_NAME "/" PROGRAM_VERSION);
+	curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, true);
+	curl_easy_setopt(curl, CURLOPT_FAILONERROR, true);
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, _on_curl_write_memory);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, body);
+
+	CURLcode response = curl_easy_perform(curl);
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, status);
+	curl_easy_cleanup(curl);
+
+	//only a 2xx is the body asked for (anything else, like a redirect not followed, isn't), although a file:// read has no status at all
+	if(response==CURLE_OK && *status && (*status<200 || *status>=300)){
+		response = CURLE_HTTP_RETURNED_ERROR;
+	}
+
+	return response;
+}
+
+#define RELEASE_CHECKSUMS "SHASUMS256.txt" //published alongside each release's archives
+#define RELEASE_CHECKSUM_RETRIES 3
+
+#define CHECKSUM_FOUND       0
+#define CHECKSUM_UNPUBLISHED 1 //there are no checksums alongside the archive, or none for it
+#define CHECKSUM_FAILED      2 //the checksums couldn't be fetched (having said why), so whether there are any isn't known
+
+// reads the SHA-256 of release `version`'s archive at `url` from the checksums published alongside it, retrying a few times if they can't be fetched
+int release_checksum(const char *url, const char *version, uint8_t sha256[32]) {
+	const char *directoryEnd = strrchr(url, '/');
+	if(!directoryEnd) return CHECKSUM_UNPUBLISHED;
+
+	char *checksumsUrl = malloc(directoryEnd-url+1+strlen(RELEASE_CHECKSUMS)+1);
+	sprintf(checksumsUrl, "%.*s/" RELEASE_CHECKSUMS, (int)(directoryEnd-url), url);
+
+	_Curl_buffer body = {
+		.buffer = malloc(4096),
+		.length = 0,
+		.size = 4096
+	};
+	body.buffer[0] = '\0';
+
+	CURLcode response;
+	long status;
+	bool missing;
+
+	for(unsigned retries=0; ; retries++){
+		body.length = 0;
+		body.buffer[0] = '\0';
+		response = fetch_buffer(checksumsUrl, &body, &status);
+
+		//only a definite answer that there's nothing there means none are published, anything else is tried again
+		missing = status==404 || status==410 || response==CURLE_FILE_COULDNT_READ_FILE || response==CURLE_REMOTE_FILE_NOT_FOUND;
+		if(response==CURLE_OK || missing || retries==RELEASE_CHECKSUM_RETRIES || ui_is_cancelled()) break;
+
+		sleep_ms(1000<<retries);
+	}
+
+	int result = missing?CHECKSUM_UNPUBLISHED:CHECKSUM_FAILED;
+
+	if(response==CURLE_OK){
+		char file[128];
+		snprintf(file, sizeof(file), "electron-v%s-" BUILDARCHSTRING ".zip", version);
+
+		result = CHECKSUM_UNPUBLISHED;
+
+		//each line is "<hex digest> <file>", with the file marked "*" if binary
+		for(char *line=body.buffer; *line && result==CHECKSUM_UNPUBLISHED; line+=strcspn(line, "\n"), line+=*line=='\n'){
+			size_t lineLength = strcspn(line, "\r\n");
+			if(lineLength<64+1) continue;
+
+			const char *name = line+64;
+			while(*name==' '||*name=='*') name++;
+
+			if((size_t)(line+lineLength-name)!=strlen(file) || strncmp(name, file, strlen(file))) continue;
+
+			result = CHECKSUM_FOUND;
+			for(unsigned i=0; i<32 && result==CHECKSUM_FOUND; i++){
+				int high = _hex_value(line[i*2]), low = _hex_value(line[i*2+1]);
+				sha256[i] = high<<4|low;
+
+				if(high<0 || low<0){
+					on_error("The checksum of Electron %s in \"%s\" can't be read", version, checksumsUrl);
+					result = CHECKSUM_FAILED;
+				}
+			}
+		}
+
+	}else if(!missing && !ui_is_cancelled()){
+		on_error("Unable to fetch the checksums for Electron %s from \"%s\"\n  %s", version, checksumsUrl, curl_easy_strerror(response));
+	}
+
+	free(body.buffer);
+	free(checksumsUrl);
+
+	return result;
+}
+
+typedef struct {
+	char *name;
+	char *url;
+} _Release;
+
+typedef struct {
+	const Version_range *range;
+	char *bestString;
+	char *bestUrl;
+
+	//or when searching for several ranges at once, every release within any of them
+	const Version_range **ranges;
+	unsigned rangeCount;
+	_Release *releases;
+	unsigned releaseCount;
+
+	bool error;
+} _Release_search;
+
+// forgets what `search` has found, ready to search again
+static void _release_search_reset(_Release_search *search) {
+	free(search->bestString);
+	free(search->bestUrl);
+	search->bestString = NULL;
+	search->bestUrl = NULL;
+
+	for(unsigned i=0; i<search->releaseCount; i++){
+		free(search->releases[i].name);
+		free(search->releases[i].url);
+	}
+	free(search->releases);
+	search->releases = NULL;
+	search->releaseCount = 0;
+
+	search->error = false;
+}
+
+// returns whether `search` found something for each of its ranges
+static bool _release_search_complete(const _Release_search *search) {
+	if(search->error) return false;
+	if(!search->ranges) return search->bestUrl!=NULL;
+
+	for(unsigned r=0; r<search->rangeCount; r++){
+		unsigned i = 0;
+		for(Version version; i<search->releaseCount; i++){
+			if(version_parse(search->releases[i].name, &version) && version_range_test(search->ranges[r], &version)) break;
+		}
+
+		if(i==search->releaseCount) return false;
+	}
+
+	return true;
+}
+
+// what a single page of the release list holds, gathered as it streams in
+typedef struct {
+	_Release_search *search;
+	Json_stream json;
+
+	bool inAssets;
+	char assetName[128];
+	char assetType[32];
+	char assetUrl[JSON_STREAM_VALUE_MAXIMUM];
+
+	char bestString[64];              //best download on this page
+	char bestUrl[JSON_STREAM_VALUE_MAXIMUM];
+
+	int lineStarts[32];               //majors whose x.0.0 releases appear on this page
+	unsigned lineStartCount;
+} _Release_page;
+
+// the list is an array of releases (depth 2), each with a "tag_name", and an "assets" array (depth 3) of objects (depth 4)
+
+static void _on_release_open(Json_stream *json, char type, void *data) {
+	_Release_page *page = data;
+
+	if(json->depth==3 && type=='[' && !strcmp(json->key, "assets")){
+		page->inAssets = true;
+
+	}else if(json->depth==4 && type=='{' && page->inAssets){
+		page->assetName[0] = '\0';
+		page->assetType[0] = '\0';
+		page->assetUrl[0] = '\0';
+	}
+}
+
+static void _on_release_close(Json_stream *json, char type, void *data) {
+	_Release_page *page = data;
+
+	if(json->depth==2 && type=='['){
+		page->inAssets = false;
+
+	}else if(json->depth==3 && type=='{' && page->inAssets){
+		_Release_search *search = page->search;
+
+		char *endName = "-" BUILDARCHSTRING ".zip";
+		size_t endNameLength = strlen(endName);
+
+		size_t nameLength = strlen(page->assetName);
+
+		if( true
+			&& nameLength > 9+endNameLength
+				&& !strncmp("electron-", page->assetName, 9)
+				&& !strcmp(endName, &page->assetName[nameLength-endNameLength])
+			&& !strcmp("application/zip", page->assetType)
+			&& page->assetUrl[0]
+		){
+			char *versionString = &page->assetName[9];
+			page->assetName[nameLength-endNameLength] = '\0';
+			while(versionString[0]=='v')versionString++;
+
+			Version version;
+			if(search->ranges && version_parse(versionString, &version)){
+				for(unsigned r=0; r<search->rangeCount; r++){
+					if(version_range_test(search->ranges[r], &version)){
+						search->releases = realloc(search->releases, (search->releaseCount+1)*sizeof(_Release));
+						search->releases[search->releaseCount++] = (_Release){
+							.name = strdup(versionString),
+							.url = strdup(page->assetUrl)
+						};
+						break;
+					}
+				}
+
+			}else if(!search->ranges && version_parse(versionString, &version) && version_range_test(search->range, &version)){
+				Version best;
+				if(!page->bestString[0] || !version_parse(page->bestString, &best) || version_compare(&version, &best)>0){
+					snprintf(page->bestString, sizeof(page->bestString), "%s", versionString);
+					snprintf(page->bestUrl, sizeof(page->bestUrl), "%s", page->assetUrl);
+				}
+			}
+		}
+	}
+}
+
+static void _on_release_string(Json_stream *json, const char *value, size_t length, bool truncated, void *data) {
+	_Release_page *page = data;
+
+	if(json->depth==2 && !strcmp(json->key, "tag_name")){
+		while(value[0]=='v')value++;
+
+		Version version;
+		if(!truncated && version_parse(value, &version)){
+			if(!(version.key>>16&0xFFFFFFFF)){ //an x.0.0
+				int major = version.key>>48;
+
+				unsigned i = 0;
+				while(i<page->lineStartCount && page->lineStarts[i]!=major) i++;
+
+				if(i==page->lineStartCount && page->lineStartCount<sizeof(page->lineStarts)/sizeof(page->lineStarts[0])){
+					page->lineStarts[page->lineStartCount++] = major;
+				}
+			}
+		}
+
+	}else if(json->depth==4 && page->inAssets && !truncated){
+		char *field = NULL;
+		size_t fieldSize = 0;
+
+		if(!strcmp(json->key, "name")){
+			field = page->assetName;
+			fieldSize = sizeof(page->assetName);
+		}else if(!strcmp(json->key, "content_type")){
+			field = page->assetType;
+			fieldSize = sizeof(page->assetType);
+		}else if(!strcmp(json->key, "browser_download_url")){
+			field = page->assetUrl;
+			fieldSize = sizeof(page->assetUrl);
+		}
+
+		if(field && length<fieldSize){
+			memcpy(field, value, length+1);
+		}
+	}
+}
+
+static bool _on_release_data(void *data, const char *body, size_t length, void *userdata) {
+	_Release_page *page = data;
+
+	if(!page->search || !body){
+		memset(page, 0, sizeof(*page));
+		page->search = userdata;
+		json_stream_init(&page->json, _on_release_open, _on_release_close, _on_release_string, page);
+	}
+
+	if(body){
+		json_stream_feed(&page->json, body, length);
+	}
+
+	return true;
+}
+
+// merges in a page of the GitHub release list, returning false once no later page could hold a better download
+static bool _on_release_page(void *data, void *userdata) {
+	_Release_page *page = data;
+	_Release_search *search = userdata;
+
+	if(!page->search){
+		//an empty response
+		on_error("Error parsing response from GitHub API (response was not valid JSON)");
+		search->error = true;
+		return false;
+	}
+
+	if(!json_stream_finish(&page->json)){
+		on_error("Error parsing response from GitHub API (response was not valid JSON)");
+		search->error = true;
+		return false;
+	}
+
+	if(page->json.root!='['){
+		on_error("Error parsing response from GitHub API");
+		search->error = true;
+		return false;
+	}
+
+	if(search->ranges) return true; //every release is wanted
+
+	Version version, best;
+	if(page->bestString[0] && version_parse(page->bestString, &version)){
+		if(!search->bestString || !version_parse(search->bestString, &best) || version_compare(&version, &best)>0){
+			free(search->bestString);
+			free(search->bestUrl);
+
+			search->bestString = strdup(page->bestString);
+			search->bestUrl = strdup(page->bestUrl);
+		}
+	}
+
+	if(!search->bestString || !version_parse(search->bestString, &best)) return true;
+
+	if(version_range_exact(search->range)) return false; //exact matches can't be beaten
+
+	//releases are listed newest first, and each release line is published in order, so once the start of the best match's line has passed nothing later can beat it
+	for(unsigned i=0; i<page->lineStartCount; i++){
+		if(page->lineStarts[i]==(int)(best.key>>48)) return false;
+	}
+
+	return true;
+}
+
+static _Thread_local bool _errorsRecoverable = false; //set while there's something else left to try, so errors are reported without ending the UI
+
+void on_error(const char *message, ...) {
+	static _Thread_local char buffer[512];
+	va_list args;
+	va_start(args, message);
+	vsnprintf(buffer, sizeof(buffer)/sizeof(buffer[0]), message, args);
+	va_end(args);
+
+	fprintf(stderr, "%s\n", buffer);
+	if(!_errorsRecoverable){
+		ui_error(buffer);
+	}
+}
+
+#ifdef _WIN32
+
+	// Windows doesn't support passing multiple parameters, and instead condenses them to a single commandline string
+	// Thus we must build this string ourselves, quote all arguments, and escape special characters
+	int execvp_win32(char *file, char *const argv[], int *launchError) {
+		char *commandline = malloc(1);
+		commandline[0] = '\0';
+		size_t commandlineLength = 0;
+
+		*launchError = 0;
+
+		int i = 0;
+		for(char *arg=argv[i]; arg; arg=argv[++i]){
+			if(arg[0]=='\0') continue;
+
+			commandline = realloc(commandline, commandlineLength+1+1+strlen(arg)*2+1+1); //allocate room for a space, open quote, double the size the string (escaping every char), a close quote, and a null
+
+			if(commandlineLength>0){
+				commandline[commandlineLength++] = ' ';
+			}
+
+			commandline[commandlineLength++] = '"';
+
+			for(;*arg;arg++){
+				unsigned escapes = 0;
+				while(*arg=='\\'){
+					commandline[commandlineLength++] = *arg;
+					escapes++;
+					arg++;
+				}
+
+				switch(*arg){
+					case '\0':
+						//if string is ending, escape all escape characters so the closing " can be parsed
+						for(int i2=0;i2<escapes;i2++){
+							commandline[commandlineLength++] = '\\';
+						}
+					break;
+					case '&':
+					case '\\':
+					case '<':
+					case '>':
+					case '^':
+					case '|':
+					case '"':
+						//also double escape if a special character follows, followed by that character, escaped
+						for(int i2=0;i2<escapes;i2++){
+							commandline[commandlineLength++] = '\\';
+						}
+						commandline[commandlineLength++] = '\\';
+						commandline[commandlineLength++] = *arg;
+					break;
+					default:
+						commandline[commandlineLength++] = *arg;
+				}
+			}
+
+			commandline[commandlineLength++] = '"';
+			commandline[commandlineLength] = '\0';
+		}
+
+		STARTUPINFO startupInfo;
+		memset(&startupInfo, 0, sizeof(startupInfo));
+		startupInfo.cb = sizeof(startupInfo);
+
+		PROCESS_INFORMATION processInfo;
+		memset(&processInfo, 0, sizeof(processInfo));
+
+		if(!CreateProcess(file, commandline, NULL, NULL, FALSE, CREATE_DEFAULT_ERROR_MODE, NULL, NULL, &startupInfo, &processInfo)){
+			*launchError = GetLastError();
+			free(commandline);
+			return 1;
+		}
+
+		int result = WaitForSingleObject(processInfo.hProcess, INFINITE);
+
+		CloseHandle(processInfo.hProcess);
+		CloseHandle(processInfo.hThread);
+
+		free(commandline);
+
+		return result;
+	}
+#endif
+
+// returns the name of the newest runtime installed within `range`, if there is one
+char *runtime_find(Runtime_index *index, const char *storePath, const Version_range *range) {
+	const Runtime *runtime = runtime_index_best(index, range);
+
+	if(runtime){
+		//make sure it's still there, in case the store has changed without the index noticing
+		char *executable = runtime_executable(storePath, runtime->name);
+		struct stat info;
+		bool found = !stat(executable, &info);
+		free(executable);
+
+		if(!found && runtime_index_rebuild(index, storePath)){
+			runtime_index_write(index, storePath);
+			runtime = runtime_index_best(index, range);
+		}
+	}
+
+	return runtime?strdup(runtime->name):NULL;
+}
+
+// reads the release list from each mirror in turn until one has something for everything `search` wants, returning whether any list could be read at all
+// `mirror` is set to the mirror the results came from
+bool runtime_search(const Mirror_list *mirrors, _Release_search *search, unsigned *mirror) {
+	const char *catalogTemplate = config_get("MIRROR_CATALOG");
+	if(!catalogTemplate) catalogTemplate = MIRROR_CATALOG_DEFAULT;
+
+	bool fetched = false;
+
+	for(*mirror=0; *mirror<mirrors->count; (*mirror)++){
+		bool github = !strcmp(mirrors->mirrors[*mirror], MIRROR_GITHUB);
+		char *catalogUrl = github?strdup(MIRROR_GITHUB_CATALOG):mirror_url(mirrors->mirrors[*mirror], catalogTemplate, NULL);
+
+		printf("Fetching release list from %s...\n", github?"GitHub":mirrors->mirrors[*mirror]);
+
+		_release_search_reset(search);
+
+		//only the last mirror's failure is final
+		_errorsRecoverable = *mirror+1<mirrors->count;
+		fetched = fetch_pages(catalogUrl, _on_release_data, sizeof(_Release_page), _on_release_page, search);
+		_errorsRecoverable = false;
+
+		free(catalogUrl);
+
+		if(ui_is_cancelled()) break;
+
+		if(fetched && _release_search_complete(search)) break;
+	}
+
+	//having run out of mirrors, what the last one had is all there is
+	if(*mirror==mirrors->count && *mirror>0) (*mirror)--;
+
+	return fetched;
+}
+
+// downloads and installs release `name` (found on `mirror` at `url`), returning the name of what's now installed within `range` in its place
+// returns NULL if that failed (having said why), or was `cancelled`
+char *runtime_install_release(Runtime_index *index, const char *storePath, const Version_range *range, const Mirror_list *mirrors, unsigned mirror, const char *release, const char *url, bool *cancelled) {
+	*cancelled = false;
+
+	const char *assetTemplate = config_get("MIRROR_ASSET");
+	if(!assetTemplate) assetTemplate = MIRROR_ASSET_DEFAULT;
+
+	char *name = strdup(release);
+
+	//only one process installs each version, so anyone else after it waits for that one to finish
+	if(!install_lock(storePath, name)){
+		*cancelled = true;
+		free(name);
+		name = NULL;
+
+	}else{
+		{ //something compatible may have been installed elsewhere while we were looking (or waiting)
+			runtime_index_free(index);
+			const Runtime *runtime = runtime_index_load(index, storePath)?runtime_index_best(index, range):NULL;
+
+			if(runtime){
+				printf("Electron %s has been installed in the meantime\n", runtime->name);
+
+				free(name);
+				name = strdup(runtime->name);
+				mirror = mirrors->count;
+			}
+		}
+
+		char *destinationFilename = malloc(strlen(name)+4+1);
+		strcpy(destinationFilename, name);
+		strcat(destinationFilename, ".zip");
+
+		char *downloadDestination = malloc(strlen(storePath)+strlen(destinationFilename)+1);
+		strcpy(downloadDestination, storePath);
+		strcat(downloadDestination, destinationFilename);
+
+		char *extractDestination = install_staging_path(storePath, name);
+
+		uint64_t installedSize = 0;
+
+		bool attempted = mirror<mirrors->count;
+		bool installed = false;
+
+		//starting with the mirror the release was found on
+		for(; !installed && mirror<mirrors->count; mirror++){
+			bool github = !strcmp(mirrors->mirrors[mirror], MIRROR_GITHUB);
+			char *mirrorUrl = github?strdup(url):mirror_url(mirrors->mirrors[mirror], assetTemplate, name);
+
+			if(github){
+				printf("Downloading Electron %s...\n", name);
+			}else{
+				printf("Downloading Electron %s from %s...\n", name, mirrors->mirrors[mirror]);
+			}
+
+			//anything already here is from an interrupted install (or an attempt from a previous mirror), so start afresh
+			remove_directory(extractDestination);
+
+			#ifdef _WIN32
+				if(mkdir(extractDestination)<0){
+					on_error("Unable to create path for writing: %s", extractDestination);
+				}
+			#else
+				if(mkdir(extractDestination, 0700)<0){
+					on_error("Unable to create path for writing: %s", extractDestination);
+				}
+			#endif
+
+			_errorsRecoverable = mirror+1<mirrors->count;
+
+			uint8_t sha256[32];
+			int checksum = release_checksum(mirrorUrl, name, sha256);
+			if(checksum==CHECKSUM_FAILED){
+				//without knowing whether there's a checksum, nothing from this mirror can be trusted
+				_errorsRecoverable = false;
+				free(mirrorUrl);
+				if(ui_is_cancelled()) break;
+				continue;
+			}
+
+			bool checked = checksum==CHECKSUM_FOUND;
+			if(!checked){
+				printf("No checksum is published for Electron %s, so it can't be verified\n", name);
+			}
+
+			//held in memory instead if asked, which saves writing the archive out and reading it back, but can't be resumed
+			const char *archiveDestination = config_get_number("DOWNLOAD_TO_MEMORY", 0)?NULL:downloadDestination;
+			installed = download_extract(mirrorUrl, archiveDestination, extractDestination, checked?sha256:NULL, &installedSize);
+			_errorsRecoverable = false;
+
+			free(mirrorUrl);
+
+			if(ui_is_cancelled()) break;
+		}
+
+		if(attempted){
+			if(installed){
+				remove(downloadDestination);
+				installed = install_publish(extractDestination, storePath, name);
+			}
+
+			if(!installed){
+				*cancelled = ui_is_cancelled();
+				remove_directory(extractDestination);
+				free(name);
+				name = NULL;
+
+			}else{
+				//other versions may have been installed alongside, so look again rather than add to what we had
+				//only the size is added to what's found, as the rest came from the store as of the look
+				if(runtime_index_rebuild(index, storePath)){
+					runtime_index_add(index, name, installedSize, RUNTIME_COMPLETE);
+					runtime_index_write(index, storePath);
+				}
+
+				Runtime_policy policy;
+				runtime_policy_read(&policy);
+				if(policy.maximumSize || policy.maximumCount){
+					runtime_collect(index, storePath, &policy, name, false);
+				}
+			}
+		}
+
+		install_unlock();
+
+		free(extractDestination);
+		free(downloadDestination);
+		free(destinationFilename);
+	}
+
+	return name;
+}
+
+// downloads and installs the newest release within `range`, from the first mirror that has it, returning its name
+// returns NULL if that failed (having said why), or was `cancelled`
+char *runtime_install(Runtime_index *index, const char *storePath, const Version_range *range, bool *cancelled) {
+	*cancelled = false;
+
+	Mirror_list mirrors;
+	mirror_list_read(&mirrors);
+
+	_Release_search search = {
+		.range = range
+	};
+	unsigned mirror;
+	bool fetched = runtime_search(&mirrors, &search, &mirror);
+
+	char *name = NULL;
+
+	if(ui_is_cancelled() || search.error){
+		*cancelled = ui_is_cancelled();
+
+	}else if(!fetched){
+		on_error("Unable to retrieve Electron download list");
+
+	}else if(!search.bestUrl){
+		on_error("Unable to find a compatible version of Electron for download");
+
+	}else{
+		name = runtime_install_release(index, storePath, range, &mirrors, mirror, search.bestString, search.bestUrl, cancelled);
+	}
+
+	_release_search_reset(&search);
+	mirror_list_free(&mirrors);
+
+	return name;
+}
+
+// records that `project` resolved to runtime `name`, found in `index`, so its next launch can go straight to it
+// it's recorded against the store time the index was built from, as the store may have changed since that was looked at
+void resolution_remember(const char *project, const Project *details, const Runtime_index *index, const char *storePath, const char *name) {
+	char *executable = runtime_executable(storePath, name);
+
+	Resolution resolution = {
+		.projectPath = details->path,
+		.packagePath = details->packagePath,
+		.packageHash = details->packageHash,
+		.storeTime = index->storeTime,
+		.requirement = details->requirement,
+		.runtime = (char*)name,
+		.executable = executable
+	};
+
+	if(file_stamp(details->packagePath, &resolution.packageStamp)){
+		resolution_write(&resolution, project);
+	}
+
+	free(executable);
+}
+
+// runs `executable` (runtime `version`) on the project, returning only if that fails (or on Windows, once it has finished)
+// runtime_use() must have been called on it first, to keep it from being removed
+int launch(char *executable, const char *version, const char *requirement, char *projectPath, char **electronParams, int electronParamCount, bool silent) {
+	printf("Launching Electron %s (%s)...\n", version, requirement);
+
+	electronParams[0] = executable;
+	electronParams[1] = projectPath;
+	electronParams[electronParamCount] = NULL;
+
+	#ifdef _WIN32
+		ui_hide();
+
+		int launchError;
+		int result = execvp_win32(executable, electronParams, &launchError);
+
+		if(launchError){
+			if(!silent&&!ui_enabled){
+				ui_init();
+			}
+			on_error("Error %i launching %s", launchError, executable);
+			result = 1;
+		}
+
+		return result;
+	#else
+		return execvp(executable, electronParams);
+	#endif
+}
+
+// -d given several projects (directly, or listed in @files) readies them all together
+// the release list is read once for all of them, the fewest releases satisfying every one are chosen, and up to INSTALL_PARALLEL of those are installed at once
+
+#define INSTALL_PARALLEL 3 //default releases installed at once
+
+typedef struct {
+	char *project;                    //absolute path, as resolutions are recorded under
+	Project details;
+	Version_range range;
+	bool compiled;
+	bool ready;                       //has a runtime installed
+} _Batch_project;
+
+typedef struct {
+	const char *storePath;
+	const Mirror_list *mirrors;
+	unsigned mirror;
+
+	_Release **releases;
+	unsigned releaseCount;
+	unsigned next;                    //next release to be taken by a worker
+	Mutex mutex;
+} _Batch_install;
+
+static void *_batch_install_main(void *data) {
+	_Batch_install *batch = data;
+
+	while(true){
+		mutex_lock(&batch->mutex);
+			_Release *release = batch->next<batch->releaseCount?batch->releases[batch->next++]:NULL;
+		mutex_unlock(&batch->mutex);
+
+		if(!release) break;
+
+		//each worker has its own index, as separate processes would
+		Version_range exact;
+		if(version_range_compile(&exact, release->name)){
+			Runtime_index index;
+			if(runtime_index_load(&index, batch->storePath)){
+				bool cancelled;
+				free(runtime_install_release(&index, batch->storePath, &exact, batch->mirrors, batch->mirror, release->name, release->url, &cancelled));
+				runtime_index_free(&index);
+			}
+
+			version_range_free(&exact);
+		}
+	}
+
+	return NULL;
+}
+
+// chooses the fewest of `search`'s releases that cover all its ranges, by repeatedly taking whichever satisfies most of those left (the newest of any tie)
+static unsigned _batch_choose(const _Release_search *search, _Release **chosen) {
+	bool *covered = calloc(search->rangeCount, sizeof(bool));
+	unsigned chosenCount = 0;
+
+	while(true){
+		_Release *best = NULL;
+		Version bestVersion;
+		unsigned bestCovers = 0;
+
+		for(unsigned i=0; i<search->releaseCount; i++){
+			Version version;
+			if(!version_parse(search->releases[i].name, &version)) continue;
+
+			unsigned covers = 0;
+			for(unsigned r=0; r<search->rangeCount; r++){
+				if(!covered[r] && version_range_test(search->ranges[r], &version)) covers++;
+			}
+
+			if(covers>bestCovers || (covers>0 && covers==bestCovers && version_compare(&version, &bestVersion)>0)){
+				best = &search->releases[i];
+				bestVersion = version;
+				bestCovers = covers;
+			}
+		}
+
+		if(!best) break;
+
+		for(unsigned r=0; r<search->rangeCount; r++){
+			if(version_range_test(search->ranges[r], &bestVersion)) covered[r] = true;
+		}
+
+		chosen[chosenCount++] = best;
+	}
+
+	free(covered);
+
+	return chosenCount;
+}
+
+// readies each of `paths` as -d would, returning whether they all have a runtime installed
+bool download_projects(char **paths, unsigned count, const char *storePath) {
+	Runtime_index index;
+	if(!runtime_index_load(&index, storePath)) return false;
+
+	_Batch_project *projects = calloc(count, sizeof(_Batch_project));
+	const Version_range **ranges = malloc(count*sizeof(Version_range*));
+	unsigned rangeCount = 0;
+
+	for(unsigned i=0; i<count; i++){
+		_Batch_project *project = &projects[i];
+		project->project = absolute_path(paths[i]);
+
+		Resolution resolution;
+		if(resolution_read(&resolution, project->project)){
+			project->ready = resolution_check(&resolution, project->project, storePath);
+			resolution_free(&resolution);
+
+			if(project->ready) continue;
+		}
+
+		int error = project_read(&project->details, paths[i]);
+
+		if(error==ENOENT){
+			fprintf(stderr, "File not found: %s" PATH_SEPARATOR "package.json\n", project->details.path);
+			continue;
+		}else if(error){
+			fprintf(stderr, "Unable to access: %s" PATH_SEPARATOR "package.json\n", project->details.path);
+			continue;
+		}else if(!project->details.requirement){
+			continue;
+		}
+
+		if(!version_range_compile(&project->range, project->details.requirement)){
+			fprintf(stderr, "Unable to parse Electron dependency version \"%s\" of %s\n", project->details.requirement, project->details.path);
+			continue;
+		}
+		project->compiled = true;
+
+		char *name = runtime_find(&index, storePath, &project->range);
+		if(name){
+			resolution_remember(project->project, &project->details, &index, storePath, name);
+			project->ready = true;
+			free(name);
+
+		}else{
+			printf("%s requires Electron %s\n", project->details.path, project->details.requirement);
+			ranges[rangeCount++] = &project->range;
+		}
+	}
+
+	runtime_index_free(&index);
+
+	if(rangeCount){
+		Mirror_list mirrors;
+		mirror_list_read(&mirrors);
+
+		_Release_search search = {
+			.ranges = ranges,
+			.rangeCount = rangeCount
+		};
+		unsigned mirror;
+		bool fetched = runtime_search(&mirrors, &search, &mirror);
+
+		if(!fetched){
+			on_error("Unable to retrieve Electron download list");
+
+		}else if(!search.error){
+			_Release **chosen = malloc(rangeCount*sizeof(_Release*));
+
+			_Batch_install batch = {
+				.storePath = storePath,
+				.mirrors = &mirrors,
+				.mirror = mirror,
+				.releases = chosen,
+				.releaseCount = _batch_choose(&search, chosen)
+			};
+			mutex_init(&batch.mutex);
+
+			unsigned workerCount = MIN(batch.releaseCount, MAX(1, config_get_number("INSTALL_PARALLEL", INSTALL_PARALLEL)));
+			Thread *workers = malloc(MAX(1, workerCount)*sizeof(Thread));
+
+			unsigned started = 0;
+			while(started<workerCount && thread_start(&workers[started], _batch_install_main, &batch)) started++;
+
+			//without any workers, install them one at a time here
+			if(!started){
+				_batch_install_main(&batch);
+			}
+
+			for(unsigned i=0; i<started; i++){
+				thread_join(workers[i]);
+			}
+
+			free(workers);
+			mutex_free(&batch.mutex);
+			free(chosen);
+		}
+
+		_release_search_reset(&search);
+		mirror_list_free(&mirrors);
+
+		//whatever's been installed, each project can now use the best it has (as a launch would)
+		if(runtime_index_load(&index, storePath)){
+			for(unsigned i=0; i<count; i++){
+				_Batch_project *project = &projects[i];
+				if(project->ready || !project->compiled) continue;
+
+				char *name = runtime_find(&index, storePath, &project->range);
+				if(name){
+					resolution_remember(project->project, &project->details, &index, storePath, name);
+					project->ready = true;
+					free(name);
+
+				}else{
+					fprintf(stderr, "Unable to install a compatible version of Electron (%s) for %s\n", project->details.requirement, project->details.path);
+				}
+			}
+
+			runtime_index_free(&index);
+		}
+	}
+
+	bool success = true;
+
+	for(unsigned i=0; i<count; i++){
+		success = success && projects[i].ready;
+
+		if(projects[i].compiled){
+			version_range_free(&projects[i].range);
+		}
+		project_free(&projects[i].details);
+		free(projects[i].project);
+	}
+
+	free(ranges);
+	free(projects);
+
+	return success;
+}
+
+// adds the projects listed in `filename` (one per line, # for comments) to `paths`
+bool read_project_list(const char *filename, char ***paths, unsigned *count) {
+	FILE *file = fopen(filename, "rb");
+	if(!file){
+		fprintf(stderr, "Unable to read: %s\n", filename);
+		return false;
+	}
+
+	char line[MAX_PATH+32];
+	while(fgets(line, sizeof(line), file)){
+		line[strcspn(line, "\r\n")] = '\0';
+
+		char *path = _config_trim(line, line+strlen(line));
+		if(!path[0] || path[0]=='#') continue;
+
+		*paths = realloc(*paths, (*count+1)*sizeof(char*));
+		(*paths)[(*count)++] = strdup(path);
+	}
+
+	fclose(file);
+
+	return true;
+}
+
+// --daemon keeps the runtimes of known projects installed ahead of their launch
+// known projects are those with a resolution recorded (so any launched before), and any listed in the APPS setting (separated as in PATH)
+// every DAEMON_INTERVAL seconds each is checked as a launch would, installing whatever it's missing (at low priority), and recording the result for its launch to go straight to
+
+#define DAEMON_INTERVAL (60*60) //default seconds between checks
+
+#ifdef _WIN32
+	#define PATH_LIST_SEPARATOR ";"
+#else
+	#define PATH_LIST_SEPARATOR ":"
+#endif
+
+#ifdef __linux__
+	#define IOPRIO_WHO_PROCESS 1
+	#define IOPRIO_CLASS_IDLE 3
+	#define IOPRIO_CLASS_SHIFT 13
+#endif
+
+typedef struct {
+	char **projects;
+	unsigned count;
+} _Daemon_projects;
+
+static void _daemon_add_project(_Daemon_projects *list, const char *project) {
+	for(unsigned i=0; i<list->count; i++){
+		if(!strcmp(list->projects[i], project)) return;
+	}
+
+	list->projects = realloc(list->projects, (list->count+1)*sizeof(char*));
+	list->projects[list->count++] = strdup(project);
+}
+
+static void _on_daemon_resolution(const char *path, const char *name, bool directory, void *data) {
+	if(directory || strchr(name, '.')) return; //temporary files end in ".tmp"
+
+	char *filename = malloc(strlen(path)+1+strlen(name)+1);
+	sprintf(filename, "%s" PATH_SEPARATOR "%s", path, name);
+
+	FILE *file = fopen(filename, "rb");
+	free(filename);
+
+	if(!file) return;
+
+	char line[MAX_PATH+32];
+	if(fgets(line, sizeof(line), file) && !strncmp(line, "project ", 8)){
+		line[strcspn(line, "\r\n")] = '\0';
+		_daemon_add_project(data, line+8);
+	}
+
+	fclose(file);
+}
+
+// brings `project` up to date as a launch would, installing its runtime if needed
+static void _daemon_prepare(const char *project, Runtime_index *index, const char *storePath) {
+	Resolution resolution;
+	if(resolution_read(&resolution, project)){
+		bool current = resolution_check(&resolution, project, storePath);
+		resolution_free(&resolution);
+
+		if(current) return;
+	}
+
+	Project details;
+	int error = project_read(&details, project);
+
+	if(error==ENOENT){
+		//it's gone, so forget about it
+		char *filename = _resolution_filename(project);
+		remove(filename);
+		free(filename);
 	}
 
-	depPosition = 1;
-	if(json_find(json, parsed, data, 0, &depPosition, "devDependencies", JSMN_OBJECT)){
+	Version_range range;
+	if(!error && details.requirement && version_range_compile(&range, details.requirement)){
+		char *name = runtime_find(index, storePath, &range);
+
+		if(!name){
+			printf("%s requires Electron %s\n", project, details.requirement);
 
-		int electronPosition = depPosition+1;
-		if(json_find(json, parsed, data, depPosition, &electronPosition, "electron-prebuilt", JSMN_STRING)){
-			*requirement = &data[json[electronPosition].start];
-			data[json[electronPosition].end] = '\0';
+			bool cancelled;
+			name = runtime_install(index, storePath, &range, &cancelled);
 		}
 
-		electronPosition = depPosition+1;
-		if(json_find(json, parsed, data, depPosition, &electronPosition, "electron", JSMN_STRING)){
-			*requirement = &data[json[electronPosition].start];
-			data[json[electronPosition].end] = '\0';
+		if(name){
+			resolution_remember(project, &details, index, storePath, name);
+			free(name);
 		}
-	}
 
-	if(*requirement){
-		*requirement = strdup(*requirement);
-	}else{
-		*requirement = strdup(">=1.0");
+		version_range_free(&range);
 	}
 
-	free(json);
+	project_free(&details);
 }
 
-void on_error(const char *message, ...) {
-	static char buffer[512];
-	va_list args;
-	va_start(args, message);
-	vsnprintf(buffer, sizeof(buffer)/sizeof(buffer[0]), message, args);
-	va_end(args);
-
-	fprintf(stderr, "%s\n", buffer);
-	ui_error(buffer);
-}
+// checks every known project once
+void daemon_check(const char *storePath) {
+	_Daemon_projects list = {0};
 
-#ifdef _WIN32
+	{
+		char path[MAX_PATH+16];
+		get_user_cache_folder(path, MAX_PATH, PROGRAM_NAME);
+		strcat(path, "resolved");
+		directory_visit(path, _on_daemon_resolution, &list);
+	}
 
-	// Windows doesn't support passing multiple parameters, and instead condenses them to a single commandline string
-	// Thus we must build this string ourselves, quote all arguments, and escape special characters
-	int execvp_win32(char *file, char *const argv[], int *launchError) {
-		char *commandline = malloc(1);
-		commandline[0] = '\0';
-		size_t commandlineLength = 0;
+	const char *apps = config_get("APPS");
+	for(const char *app=apps; app && *app; app+=strspn(app, PATH_LIST_SEPARATOR)){
+		size_t length = strcspn(app, PATH_LIST_SEPARATOR);
 
-		*launchError = 0;
+		char *path = malloc(length+1);
+		memcpy(path, app, length);
+		path[length] = '\0';
 
-		int i = 0;
-		for(char *arg=argv[i]; arg; arg=argv[++i]){
-			if(arg[0]=='\0') continue;
+		strip_trailing_separators(path);
 
-			commandline = realloc(commandline, commandlineLength+1+1+strlen(arg)*2+1+1); //allocate room for a space, open quote, double the size the string (escaping every char), a close quote, and a null
+		if(path[0]){
+			char *project = absolute_path(path);
+			_daemon_add_project(&list, project);
+			free(project);
+		}
 
-			if(commandlineLength>0){
-				commandline[commandlineLength++] = ' ';
-			}
+		free(path);
+		app += strcspn(app, PATH_LIST_SEPARATOR);
+	}
 
-			commandline[commandlineLength++] = '"';
+	Runtime_index index;
+	if(runtime_index_load(&index, storePath)){
+		//installing changes the store, which every resolution depends on, so go round again to record them afresh
+		for(unsigned pass=0; pass<2; pass++){
+			int64_t storeTime = _runtime_store_time(storePath);
 
-			for(;*arg;arg++){
-				unsigned escapes = 0;
-				while(*arg=='\\'){
-					commandline[commandlineLength++] = *arg;
-					escapes++;
-					arg++;
-				}
+			//resolutions are recorded against the index's store time, so it has to be current
+			if(index.storeTime!=storeTime){
+				runtime_index_free(&index);
+				if(!runtime_index_load(&index, storePath)) break;
+			}
 
-				switch(*arg){
-					case '\0':
-						//if string is ending, escape all escape characters so the closing " can be parsed
-						for(int i2=0;i2<escapes;i2++){
-							commandline[commandlineLength++] = '\\';
-						}
-					break;
-					case '&':
-					case '\\':
-					case '<':
-					case '>':
-					case '^':
-					case '|':
-					case '"':
-						//also double escape if a special character follows, followed by that character, escaped
-						for(int i2=0;i2<escapes;i2++){
-							commandline[commandlineLength++] = '\\';
-						}
-						commandline[commandlineLength++] = '\\';
-						commandline[commandlineLength++] = *arg;
-					break;
-					default:
-						commandline[commandlineLength++] = *arg;
-				}
+			for(unsigned i=0; i<list.count; i++){
+				_daemon_prepare(list.projects[i], &index, storePath);
 			}
 
-			commandline[commandlineLength++] = '"';
-			commandline[commandlineLength] = '\0';
+			if(_runtime_store_time(storePath)==storeTime) break;
 		}
 
-		STARTUPINFO startupInfo;
-		memset(&startupInfo, 0, sizeof(startupInfo));
-		startupInfo.cb = sizeof(startupInfo);
+		runtime_index_free(&index);
+	}
 
-		PROCESS_INFORMATION processInfo;
-		memset(&processInfo, 0, sizeof(processInfo));
+	for(unsigned i=0; i<list.count; i++){
+		free(list.projects[i]);
+	}
+	free(list.projects);
+}
 
-		if(!CreateProcess(file, commandline, NULL, NULL, FALSE, CREATE_DEFAULT_ERROR_MODE, NULL, NULL, &startupInfo, &processInfo)){
-			*launchError = GetLastError();
-			free(commandline);
-			return 1;
-		}
+// runs until killed, checking all known projects every DAEMON_INTERVAL seconds
+int run_daemon(const char *storePath) {
+	char filename[MAX_PATH+16];
+	get_user_cache_folder(filename, MAX_PATH, PROGRAM_NAME);
+	strcat(filename, "daemon.lock");
 
-		int result = WaitForSingleObject(processInfo.hProcess, INFINITE);
+	File_lock lock;
+	if(!file_lock(filename, true, false, &lock)){
+		fprintf(stderr, "The daemon is already running\n");
+		return 1;
+	}
 
-		CloseHandle(processInfo.hProcess);
-		CloseHandle(processInfo.hThread);
+	//launches come first
+	#ifdef _WIN32
+		SetPriorityClass(GetCurrentProcess(), PROCESS_MODE_BACKGROUND_BEGIN);
+	#else
+		nice(19);
+		#ifdef __linux__
+			syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE<<IOPRIO_CLASS_SHIFT);
+		#endif
+	#endif
 
-		free(commandline);
+	while(true){
+		config_reload();
 
-		return result;
+		daemon_check(storePath);
+		fflush(stdout);
+
+		long interval = MAX(1, config_get_number("DAEMON_INTERVAL", DAEMON_INTERVAL));
+		for(long i=0; i<interval; i++){
+			sleep_ms(1000);
+		}
 	}
-#endif
+
+	return 0;
+}
 
 int main(int argc, const char *argv[]) {
 	char *projectPath = "app";
@@ -919,6 +8445,7 @@ int main(int argc, const char *argv[]) {
 	bool noDownload = false;
 	bool downloadOnly = false;
 	bool silent = false;
+	bool daemon = false;
 
 	char **electronParams = malloc((argc+1+1)*sizeof(const char*)); // +1 in case a project path wasn't included and we append one, +1 for end null
 	int electronParamCount = 2; //we'll leave room for the electron path and the project path, which will be param 1
@@ -940,14 +8467,7 @@ int main(int argc, const char *argv[]) {
 			if(!projectPathSpecified && arg[0]!='-'){
 				projectPathSpecified = true;
 				projectPath = strdup(arg);
-
-				{ //strip trailing slashes
-					int length = strlen(projectPath);
-					while(length>0&&(projectPath[length-1]=='/'||projectPath[length-1]=='\\')){
-						projectPath[--length]='\0';
-					}
-				}
-
+				strip_trailing_separators(projectPath);
 				continue;
 
 			}else if(!strcmp(arg,"-h")||!strcmp(arg,"--help")){
@@ -958,6 +8478,13 @@ int main(int argc, const char *argv[]) {
 				print_downloads();
 				return 0;
 
+			}else if(!strcmp(arg,"--gc")){
+				return collect_garbage()?0:1;
+
+			}else if(!strcmp(arg,"--daemon")){
+				daemon = true;
+				continue;
+
 			}else if(!strcmp(arg,"-v")||!strcmp(arg,"--version")){
 				print_version();
 				return 0;
@@ -980,151 +8507,116 @@ int main(int argc, const char *argv[]) {
 		electronParams[electronParamCount] = NULL;
 	}
 
-	char *electronRequirement;
-
-	{ //read project file
-
-		char *projectFile;
+	char storePath[MAX_PATH+8];
+	get_user_cache_folder(storePath, MAX_PATH, PROGRAM_NAME);
+	strcat(storePath, "runtime" PATH_SEPARATOR);
+	#ifdef _WIN32
+		mkdir(storePath);
+	#else
+		mkdir(storePath, 0700);
+	#endif
 
-		{
-			int error = read_file(projectPath, "package.json", &projectFile);
+	curl_global_init(CURL_GLOBAL_DEFAULT);
 
-			if(error==ENOENT){
-				char *projectPathExtended = malloc(strlen(projectPath)+5+1);
-				strcpy(projectPathExtended, projectPath);
-				strcat(projectPathExtended, ".asar");
+	if(daemon){
+		return run_daemon(storePath);
+	}
 
-				error = read_file(projectPathExtended, "package.json", &projectFile);
-				if(error!=ENOENT){
-					projectPath = projectPathExtended;
-				}
-			}
+	if(downloadOnly){
+		//any further paths (or @files listing them) are more projects to ready at once
+		char **projects = NULL;
+		unsigned projectCount = 0;
+		bool batch = false;
 
-			if(error){
-				if(error==ENOENT){
-					fprintf(stderr, "File not found: %s" PATH_SEPARATOR "package.json\n", projectPath);
-				}else{
-					fprintf(stderr, "Unable to access: %s" PATH_SEPARATOR "package.json\n", projectPath);
-				}
+		for(int i=1; i<electronParamCount; i++){
+			const char *path = i==1?projectPath:electronParams[i];
+			if(path[0]=='-') continue;
 
-				printf("\n");
-				print_help(argv[0]);
+			if(path[0]=='@'){
+				if(!read_project_list(path+1, &projects, &projectCount)) return 1;
+				batch = true;
 
-				return 1;
+			}else{
+				projects = realloc(projects, (projectCount+1)*sizeof(char*));
+				projects[projectCount++] = strdup(path);
+				batch = batch || i>1;
 			}
 		}
 
-		read_electron_requirement(&electronRequirement, projectFile);
+		if(batch){
+			for(unsigned i=0; i<projectCount; i++){
+				strip_trailing_separators(projects[i]);
+			}
 
-		if(!electronRequirement){
-			return 1;
+			return download_projects(projects, projectCount, storePath)?0:1;
 		}
 
-		free(projectFile);
+		for(unsigned i=0; i<projectCount; i++){
+			free(projects[i]);
+		}
+		free(projects);
 	}
 
-	//FIXME: we only support a single operator and semver requirement for now ("~x.x.x" etc). We're meant to support sets, too (like "1.2.7 || >=1.2.9 <2.0.0"). Just.. that's more work
-	semver_t versionRequirement;
-	char versionOp[3] = "=\0";
-
-	{
-		char *semverString = electronRequirement;
+	char *project = absolute_path(projectPath);
 
-		{ //read first 2 symbols (non-numbers) as operator
-			if(*semverString && (*semverString<='0'||*semverString>='9')){
-				versionOp[0] = *semverString;
-				semverString++;
+	{ //launch straight away if nothing has changed since last time
+		Resolution resolution;
+		if(resolution_read(&resolution, project)){
+			if(resolution_check(&resolution, project, storePath)){
+				if(downloadOnly) return 0;
 
-				if(*semverString && (*semverString<='0'||*semverString>='9')){
-					versionOp[1] = *semverString;
-					semverString++;
+				if(runtime_use(resolution.executable)){
+					return launch(resolution.executable, resolution.runtime, resolution.requirement, resolution.projectPath, electronParams, electronParamCount, silent);
 				}
-			}
-		}
 
-		{ //strip off *all* additional "=" or "v" as per npm-semver
-			while(*semverString=='='||*semverString=='v'){
-				semverString++;
+				//it was removed since the check, so forget it and resolve afresh
+				char *filename = _resolution_filename(project);
+				remove(filename);
+				free(filename);
 			}
-		}
 
-		if(semver_parse(semverString, &versionRequirement)){
-			fprintf(stderr, "Unable to parse Electron dependency version \"%s\"\n", electronRequirement);
-			return 1;
+			resolution_free(&resolution);
 		}
 	}
 
-	char storePath[MAX_PATH+8];
-	get_user_cache_folder(storePath, MAX_PATH, PROGRAM_NAME);
-	strcat(storePath, "runtime" PATH_SEPARATOR);
-	#ifdef _WIN32
-		mkdir(storePath);
-	#else
-		mkdir(storePath, 0700);
-	#endif
-
-	semver_t bestVersion;
-	char *bestVersionString = NULL;
-	{
-	#ifdef _WIN32
-		WIN32_FIND_DATA findData;
-
-		char *storePathSearch = malloc(strlen(storePath)+2);
-		strcpy(storePathSearch, storePath);
-		strcat(storePathSearch, "*"); //put a wildcard star on the end
+	Project details;
 
-		HANDLE search = FindFirstFile(storePathSearch, &findData);
-			free(storePathSearch);
+	{ //read project file
+		int error = project_read(&details, projectPath);
 
-			if(search==INVALID_HANDLE_VALUE && GetLastError()!=ERROR_FILE_NOT_FOUND){
-				on_error("Unable to access path: %s", storePath);
-				return 1;
+		if(error){
+			if(error==ENOENT){
+				fprintf(stderr, "File not found: %s" PATH_SEPARATOR "package.json\n", details.path);
+			}else{
+				fprintf(stderr, "Unable to access: %s" PATH_SEPARATOR "package.json\n", details.path);
 			}
 
-			if(search!=INVALID_HANDLE_VALUE){
-				do{
-					if(findData.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY && findData.cFileName[0]!='.'){
-						semver_t version;
+			printf("\n");
+			print_help(argv[0]);
 
-						if(!semver_parse(findData.cFileName, &version)){
-							if((!version.prerelease || versionRequirement.prerelease) && semver_satisfies(version, versionRequirement, versionOp) && (!bestVersionString || semver_compare(version, bestVersion)>0)){
-								bestVersion = version;
-								free(bestVersionString);
-								bestVersionString = strdup(findData.cFileName);
-							}
-						}
-					}
-				}while(FindNextFile(search, &findData));
-			}
-		FindClose(search);
+			return 1;
+		}
 
-	#else
-		DIR *dir = opendir(storePath);
-			if(!dir){
-				on_error("Unable to access path: %s", storePath);
-				return 1;
-			}
+		if(!details.requirement){
+			return 1;
+		}
+	}
 
-			struct dirent *entry;
-			while(entry = readdir(dir)){
-				if(entry->d_type==DT_DIR && entry->d_name[0]!='.'){
-					semver_t version;
+	Version_range versionRange;
+	if(!version_range_compile(&versionRange, details.requirement)){
+		fprintf(stderr, "Unable to parse Electron dependency version \"%s\"\n", details.requirement);
+		return 1;
+	}
 
-					if(!semver_parse(entry->d_name, &version)){
-						if((!version.prerelease || versionRequirement.prerelease) && semver_satisfies(version, versionRequirement, versionOp) && (!bestVersionString || semver_compare(version, bestVersion)>0)){
-							bestVersion = version;
-							free(bestVersionString);
-							bestVersionString = strdup(entry->d_name);
-						}
-					}
-				}
-			}
-		closedir(dir);
-	#endif
+	Runtime_index runtimeIndex;
+	if(!runtime_index_load(&runtimeIndex, storePath)){
+		return 1;
 	}
 
+	char *bestVersionString = runtime_find(&runtimeIndex, storePath, &versionRange);
+
 	if(!bestVersionString){
-		printf("This application requires Electron %s\n", electronRequirement);
+		printf("This application requires Electron %s\n", details.requirement);
 
 		if(noDownload){
 			fprintf(stderr, "A compatible version is not currently downloaded\n");
@@ -1135,192 +8627,26 @@ int main(int argc, const char *argv[]) {
 			ui_init();
 		}
 
-		printf("Fetching release list from GitHub...\n");
-
-		const char *apiUrl = "https://api.github.com/repos/electron/electron/releases?per_page=100"; //FIXME: only pulls the last 100 releases. Really we should be paginating this list
-		char *api;
-		fetch(&api, apiUrl);
-
-		if(ui_is_cancelled()) return 0;
-
-		if(!api){
-			on_error("Unable to retrieve Electron download list");
-			return 1;
-		}
-
-		jsmn_parser jsonParser;
-		jsmntok_t *json;
-
-		int parsed = json_init(&jsonParser, &json, api);
-
-		if(!json){
-			return 1;
-		}
-
-		if(parsed<1){
-			on_error("Error parsing response from GitHub API (response was not valid JSON)");
-			return 1;
-		}
+		bool cancelled;
+		bestVersionString = runtime_install(&runtimeIndex, storePath, &versionRange, &cancelled);
 
-		if(json[0].type!=JSMN_ARRAY){
-			on_error("Error parsing response from GitHub API");
-			return 1;
+		if(!bestVersionString){
+			return cancelled?0:1;
 		}
+	}
 
-		char *bestVersionUrl = NULL;
-
-		{
-			semver_t bestVersion;
-
-			int position = 1;
-
-			char *endName = "-" BUILDARCHSTRING ".zip";
-			int endNameLength = strlen(endName);
-
-			while(position<parsed){
-				if(json[position].type!=JSMN_OBJECT){
-					json_next(json, parsed, &position);
-					continue;
-				}
-
-				int releasePosition = position;
-
-				int tagPosition = releasePosition+1;
-				if(json_find(json, parsed, api, releasePosition, &tagPosition, "tag_name", JSMN_STRING)){
-					char *tag = &api[json[tagPosition].start];
-					api[json[tagPosition].end] = '\0';
-
-					int assetsPosition = releasePosition+1;
-					if(json_find(json, parsed, api, releasePosition, &assetsPosition, "assets", JSMN_ARRAY)){
-
-						int afterAssets = assetsPosition;
-						json_next(json, parsed, &afterAssets);
-
-						for(int assetPosition=assetsPosition+1; assetPosition<afterAssets; json_next(json, parsed, &assetPosition)){
-							int namePosition = assetPosition+1;
-							int typePosition = assetPosition+1;
-							int urlPosition = assetPosition+1;
-							if( true
-								&& json_find(json, parsed, api, assetPosition, &namePosition, "name", JSMN_STRING)
-									&& json[namePosition].end-json[namePosition].start > 9+endNameLength
-									&& !strncmp("electron-", &api[json[namePosition].start], 9)
-									&& !strncmp(endName, &api[json[namePosition].end-endNameLength], endNameLength)
-								&& json_find(json, parsed, api, assetPosition, &typePosition, "content_type", JSMN_STRING)
-									&& json[typePosition].end-json[typePosition].start == 15
-									&& !strncmp("application/zip", &api[json[typePosition].start], 15)
-								&& json_find(json, parsed, api, assetPosition, &urlPosition, "browser_download_url", JSMN_STRING)
-							){
-								char *versionString = &api[json[namePosition].start+9];
-								api[json[namePosition].end-endNameLength] = '\0';
-								while(versionString[0]=='v')versionString++;
-
-								char *url = &api[json[urlPosition].start];
-								api[json[urlPosition].end] = '\0';
-
-								semver_t version;
-								if(!semver_parse(versionString, &version)){
-									if((!version.prerelease || versionRequirement.prerelease) && semver_satisfies(version, versionRequirement, versionOp) && (!bestVersionString || semver_compare(version, bestVersion)>0)){
-										bestVersion = version;
-										free(bestVersionString);
-										bestVersionString = strdup(versionString);
-										bestVersionUrl = strdup(url);
-									}
-								}
-							}
-						}
-					}
-				}
-
-				json_next(json, parsed, &position);
-			}
-		}
+	//remember all this for next time
+	resolution_remember(project, &details, &runtimeIndex, storePath, bestVersionString);
 
-		free(json);
+	char *electronPath = runtime_executable(storePath, bestVersionString);
 
-		if(!bestVersionUrl){
-			on_error("Unable to find a compatible version of Electron for download");
+	if(!downloadOnly){
+		if(!runtime_use(electronPath)){
+			on_error("Electron %s has been removed", bestVersionString);
 			return 1;
 		}
 
-		printf("Downloading Electron %s...\n", bestVersionString);
-
-		{
-			char *destinationFilename = malloc(strlen(bestVersionString)+4+1);
-			strcpy(destinationFilename, bestVersionString);
-			strcat(destinationFilename, ".zip");
-
-			char *downloadDestination = malloc(strlen(storePath)+strlen(destinationFilename)+1);
-			strcpy(downloadDestination, storePath);
-			strcat(downloadDestination, destinationFilename);
-
-			char *extractDestination = malloc(strlen(storePath)+strlen(bestVersionString)+1);
-			strcpy(extractDestination, storePath);
-			strcat(extractDestination, bestVersionString);
-
-			if(!download(bestVersionUrl, downloadDestination)){
-				if(ui_is_cancelled()) return 0;
-
-				return 1;
-			}
-
-			printf("Extracting...\n");
-
-			#ifdef _WIN32
-				if(mkdir(extractDestination)<0){
-					on_error("Unable to create path for writing: %s", extractDestination);
-				}
-			#else
-				if(mkdir(extractDestination, 0700)<0){
-					on_error("Unable to create path for writing: %s", extractDestination);
-				}
-			#endif
-
-			if(!extract_files(downloadDestination, extractDestination)){
-				rmdir(extractDestination);
-
-				if(ui_is_cancelled()) return 0;
-
-				on_error("An error occurred extracting the downloaded Electron archive");
-				return 1;
-			}
-
-			remove(downloadDestination);
-		}
-	}
-
-	if(!downloadOnly){
-		printf("Launching Electron %s (%s)...\n", bestVersionString, electronRequirement);
-
-		#ifdef _WIN32
-			char *electronPath = malloc(strlen(storePath)+strlen(bestVersionString)+1+12+1);
-			sprintf(electronPath, "%s%s" PATH_SEPARATOR "electron.exe", storePath, bestVersionString);
-		#else
-			char *electronPath = malloc(strlen(storePath)+strlen(bestVersionString)+1+8+1);
-			sprintf(electronPath, "%s%s" PATH_SEPARATOR "electron", storePath, bestVersionString);
-		#endif
-
-		electronParams[0] = electronPath;
-		electronParams[1] = projectPath;
-		electronParams[electronParamCount] = NULL;
-
-		#ifdef _WIN32
-			ui_hide();
-
-			int launchError;
-			int result = execvp_win32(electronPath, electronParams, &launchError);
-
-			if(launchError){
-				if(!silent&&!ui_enabled){
-					ui_init();
-				}
-				on_error("Error %i launching %s", launchError, electronPath);
-				result = 1;
-			}
-
-			return result;
-		#else
-			return execvp(electronPath, electronParams);
-		#endif
+		return launch(electronPath, bestVersionString, details.requirement, details.path, electronParams, electronParamCount, silent);
 	}
 
 	return 0;
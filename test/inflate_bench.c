@@ -0,0 +1,197 @@
+// compares the backends an Electron archive is extracted and checked with:
+//   the built-in inflater against miniz's tinfl (as used with ELECTRON_SHARED_INFLATE=miniz), each inflating every entry into memory,
+//   crc32_update() against miniz's mz_crc32() over what's inflated,
+//   and the SHA-256 of the whole archive with the instructions the processor has against the portable code
+// usage: inflate_bench electron-v<version>-<platform>.zip
+// without an archive (as under `make bench`) it's skipped, as one made up wouldn't compress like the real thing
+
+#define main electron_shared_main
+#include "../source/main.c"
+#undef main
+
+#define BENCH_RUNS 5
+
+static double _bench_time() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec+now.tv_nsec/1e9;
+}
+
+typedef struct {
+	const Archive_entry *entry;
+	const uint8_t *compressed;
+} _Bench_entry;
+
+typedef struct {
+	uint8_t *data;
+	size_t length;
+	size_t size;
+} _Bench_output;
+
+static int _bench_put(const void *buffer, int length, void *data) {
+	_Bench_output *output = data;
+	if((size_t)length>output->size-output->length) return 0;
+
+	memcpy(output->data+output->length, buffer, length);
+	output->length += length;
+	return 1;
+}
+
+static bool _bench_inflate_builtin(const _Bench_entry *entry, _Bench_output *output) {
+	return inflate_buffer(entry->compressed, entry->entry->compressedSize, entry->entry->uncompressedSize, _bench_put, output);
+}
+
+static bool _bench_inflate_miniz(const _Bench_entry *entry, _Bench_output *output) {
+	size_t compressedSize = entry->entry->compressedSize;
+	return tinfl_decompress_mem_to_callback(entry->compressed, &compressedSize, _bench_put, output, 0);
+}
+
+// inflates every entry with `inflate`, checking each against its CRC-32, and returns the fastest of the runs
+static double _bench_inflate(const char *label, bool (*inflate)(const _Bench_entry*, _Bench_output*), const _Bench_entry *entries, size_t count, _Bench_output *output, uint64_t size) {
+	double fastest = 1e9;
+
+	for(int i=0; i<BENCH_RUNS; i++){
+		double time = 0;
+
+		for(size_t j=0; j<count; j++){
+			output->length = 0;
+
+			double start = _bench_time();
+			bool inflated = inflate(&entries[j], output);
+			time += _bench_time()-start;
+
+			if(!inflated || output->length!=entries[j].entry->uncompressedSize || mz_crc32(MZ_CRC32_INIT, output->data, output->length)!=entries[j].entry->crc32){
+				fprintf(stderr, "%s inflated \"%s\" wrongly\n", label, entries[j].entry->name);
+				return -1;
+			}
+		}
+
+		fastest = MIN(fastest, time);
+	}
+
+	printf("  %-36s %8.2f ms  %7.1f MB/s\n", label, fastest*1000, size/fastest/1e6);
+	return fastest;
+}
+
+static uint32_t _bench_crc32_selected(const uint8_t *data, size_t length) {
+	return crc32_update(MZ_CRC32_INIT, data, length);
+}
+
+static uint32_t _bench_crc32_miniz(const uint8_t *data, size_t length) {
+	return mz_crc32(MZ_CRC32_INIT, data, length);
+}
+
+// the CRC-32 of each entry once inflated
+static double _bench_crc32(const char *label, uint32_t (*crc32)(const uint8_t*, size_t), const _Bench_entry *entries, size_t count, _Bench_output *output, uint64_t size) {
+	double fastest = 1e9;
+
+	for(int i=0; i<BENCH_RUNS; i++){
+		double time = 0;
+
+		for(size_t j=0; j<count; j++){
+			output->length = 0;
+			_bench_inflate_builtin(&entries[j], output);
+
+			double start = _bench_time();
+			uint32_t crc = crc32(output->data, output->length);
+			time += _bench_time()-start;
+
+			if(crc!=entries[j].entry->crc32){
+				fprintf(stderr, "%s differs for \"%s\"\n", label, entries[j].entry->name);
+				return -1;
+			}
+		}
+
+		fastest = MIN(fastest, time);
+	}
+
+	printf("  %-36s %8.2f ms  %7.1f MB/s\n", label, fastest*1000, size/fastest/1e6);
+	return fastest;
+}
+
+static double _bench_sha256(const char *label, _Sha256_blocks blocks, const uint8_t *data, size_t length, uint8_t digest[32]) {
+	double fastest = 1e9;
+
+	for(int i=0; i<BENCH_RUNS; i++){
+		__atomic_store_n(&_sha256_blocks, blocks, __ATOMIC_RELAXED);
+
+		double start = _bench_time();
+		Sha256 sha;
+		sha256_init(&sha);
+		sha256_update(&sha, data, length);
+		sha256_finish(&sha, digest);
+		fastest = MIN(fastest, _bench_time()-start);
+	}
+
+	printf("  %-36s %8.2f ms  %7.1f MB/s\n", label, fastest*1000, length/fastest/1e6);
+	return fastest;
+}
+
+int main(int argc, char *argv[]) {
+	if(argc<2){
+		printf("inflate_bench: skipped, pass it an Electron archive to time\n");
+		return 0;
+	}
+
+	Mapped_file mapped;
+	Archive archive;
+	if(!map_file(argv[1], &mapped) || !archive_locate_directory(&archive, mapped.data, mapped.size, mapped.size) || !archive_read_directory(&archive, mapped.data+archive.directoryOffset)){
+		fprintf(stderr, "Unable to read \"%s\"\n", argv[1]);
+		return 1;
+	}
+
+	//only what's deflated, which is nearly everything
+	_Bench_entry *entries = malloc((archive.entryCount+1)*sizeof(_Bench_entry));
+	size_t count = 0;
+	uint64_t size = 0;
+	uint64_t largest = 0;
+
+	for(size_t i=0; i<archive.entryCount; i++){
+		const Archive_entry *entry = &archive.entries[i];
+		const uint8_t *header = mapped.data+entry->offset;
+		if(entry->method!=8 || entry->offset+30>entry->end || _read32(header)!=0x04034b50) continue;
+
+		entries[count].entry = entry;
+		entries[count].compressed = header+30+_read16(header+26)+_read16(header+28);
+		count++;
+
+		size += entry->uncompressedSize;
+		largest = MAX(largest, entry->uncompressedSize);
+	}
+
+	_Bench_output output = {
+		.data = malloc(largest+1),
+		.size = largest
+	};
+
+	printf("%s: %.1f MB, %zu entries deflated to %.1f MB, best of %i runs\n", argv[1], mapped.size/1e6, count, size/1e6, BENCH_RUNS);
+
+	_Sha256_blocks selectedSha256 = _sha256_select();
+	_Crc32_blocks selectedCrc32 = _crc32_select();
+
+	bool success =
+		_bench_inflate("built-in inflate (as shipped)", _bench_inflate_builtin, entries, count, &output, size)>=0 &&
+		_bench_inflate("miniz tinfl", _bench_inflate_miniz, entries, count, &output, size)>=0 &&
+		_bench_crc32(selectedCrc32==_crc32_blocks_portable?"crc32_update() (no instructions)":"crc32_update() (with instructions)", _bench_crc32_selected, entries, count, &output, size)>=0 &&
+		_bench_crc32("mz_crc32()", _bench_crc32_miniz, entries, count, &output, size)>=0;
+
+	if(success){
+		uint8_t selectedDigest[32];
+		uint8_t portableDigest[32];
+		_bench_sha256(selectedSha256==_sha256_blocks_portable?"SHA-256 (no instructions)":"SHA-256 (with instructions)", selectedSha256, mapped.data, mapped.size, selectedDigest);
+		_bench_sha256("SHA-256 portable", _sha256_blocks_portable, mapped.data, mapped.size, portableDigest);
+		__atomic_store_n(&_sha256_blocks, selectedSha256, __ATOMIC_RELAXED);
+
+		success = !memcmp(selectedDigest, portableDigest, 32);
+		if(!success){
+			fprintf(stderr, "The SHA-256 digests differ\n");
+		}
+	}
+
+	free(output.data);
+	free(entries);
+	archive_free(&archive);
+	unmap_file(&mapped);
+
+	return success?0:1;
+}
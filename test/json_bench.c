@@ -0,0 +1,335 @@
+// compares ways of finding the downloads in a page of the GitHub release list:
+//   the original double jsmn parse with json_find()/json_next() walking sibling tokens,
+//   the single parse into the arena with its subtree index and json_query(),
+//   and the streaming scanner the release list is actually read with
+// usage: json_bench [releases.json] (a saved https://api.github.com/repos/electron/electron/releases?per_page=100),
+// or without one, a page of the same shape is made up
+
+#define main electron_shared_main
+#include "../source/main.c"
+#undef main
+
+#define BENCH_RUNS 20
+
+static double _bench_time() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec+now.tv_nsec/1e9;
+}
+
+typedef struct {
+	char *data;
+	size_t length;
+	size_t size;
+} _Bench_buffer;
+
+static void _bench_append(_Bench_buffer *buffer, const char *format, ...) {
+	va_list args;
+	while(true){
+		va_start(args, format);
+		int length = vsnprintf(buffer->data+buffer->length, buffer->size-buffer->length, format, args);
+		va_end(args);
+
+		if(buffer->length+length<buffer->size){
+			buffer->length += length;
+			return;
+		}
+
+		buffer->size = (buffer->size+length)*2;
+		buffer->data = realloc(buffer->data, buffer->size);
+	}
+}
+
+// a page of 100 releases as GitHub sends them, each with a long markdown body and the 80 or so assets Electron publishes
+static char *_bench_make_page(size_t *length) {
+	static const char *platforms[] = {"darwin-x64", "darwin-arm64", "linux-arm64", "linux-armv7l", "linux-ia32", "linux-x64", "mas-x64", "mas-arm64", "win32-arm64", "win32-ia32", "win32-x64"};
+	static const char *kinds[] = {"electron-v%s-%s.zip", "electron-v%s-%s-symbols.zip", "electron-v%s-%s-dsym.zip", "chromedriver-v%s-%s.zip", "ffmpeg-v%s-%s.zip", "mksnapshot-v%s-%s.zip", "electron-v%s-%s-pdb.zip"};
+	const char *uploader =
+		"{\"login\":\"electron-bot\",\"id\":18403005,\"node_id\":\"MDQ6VXNlcjE4NDAzMDA1\",\"avatar_url\":\"https://avatars.githubusercontent.com/u/18403005?v=4\","
+		"\"gravatar_id\":\"\",\"url\":\"https://api.github.com/users/electron-bot\",\"html_url\":\"https://github.com/electron-bot\","
+		"\"followers_url\":\"https://api.github.com/users/electron-bot/followers\",\"following_url\":\"https://api.github.com/users/electron-bot/following{/other_user}\","
+		"\"gists_url\":\"https://api.github.com/users/electron-bot/gists{/gist_id}\",\"starred_url\":\"https://api.github.com/users/electron-bot/starred{/owner}{/repo}\","
+		"\"subscriptions_url\":\"https://api.github.com/users/electron-bot/subscriptions\",\"organizations_url\":\"https://api.github.com/users/electron-bot/orgs\","
+		"\"repos_url\":\"https://api.github.com/users/electron-bot/repos\",\"events_url\":\"https://api.github.com/users/electron-bot/events{/privacy}\","
+		"\"received_events_url\":\"https://api.github.com/users/electron-bot/received_events\",\"type\":\"User\",\"site_admin\":false}";
+
+	_Bench_buffer page = {0};
+	_bench_append(&page, "[");
+
+	for(int release=0; release<100; release++){
+		char version[32];
+		snprintf(version, sizeof(version), "%i.%i.%i", 30-release/10, release%10, release%3);
+
+		_bench_append(&page, "%s{\"url\":\"https://api.github.com/repos/electron/electron/releases/%i\",\"assets_url\":\"https://api.github.com/repos/electron/electron/releases/%i/assets\","
+			"\"upload_url\":\"https://uploads.github.com/repos/electron/electron/releases/%i/assets{?name,label}\",\"html_url\":\"https://github.com/electron/electron/releases/tag/v%s\","
+			"\"id\":%i,\"author\":%s,\"node_id\":\"RE_kwDOAI8xS84Ja%i\",\"tag_name\":\"v%s\",\"target_commitish\":\"%i-x-y\",\"name\":\"electron v%s\",\"draft\":false,\"prerelease\":false,"
+			"\"created_at\":\"2024-05-0%iT16:31:41Z\",\"published_at\":\"2024-05-0%iT18:02:13Z\",\"assets\":[",
+			release?",":"", 150000000+release, 150000000+release, 150000000+release, version, 150000000+release, uploader, release, version, 30-release/10, version, release%9+1, release%9+1);
+
+		int asset = 0;
+		for(unsigned k=0; k<sizeof(kinds)/sizeof(kinds[0]); k++){
+			for(unsigned p=0; p<sizeof(platforms)/sizeof(platforms[0]); p++, asset++){
+				char name[128];
+				snprintf(name, sizeof(name), kinds[k], version, platforms[p]);
+
+				_bench_append(&page, "%s{\"url\":\"https://api.github.com/repos/electron/electron/releases/assets/%i\",\"id\":%i,\"node_id\":\"RA_kwDOAI8xS84Kx%i\",\"name\":\"%s\",\"label\":\"\","
+					"\"uploader\":%s,\"content_type\":\"application/zip\",\"state\":\"uploaded\",\"size\":%i,\"download_count\":%i,"
+					"\"created_at\":\"2024-05-01T16:31:42Z\",\"updated_at\":\"2024-05-01T16:31:43Z\",\"browser_download_url\":\"https://github.com/electron/electron/releases/download/v%s/%s\"}",
+					asset?",":"", 160000000+release*100+asset, 160000000+release*100+asset, asset, name, uploader, 90000000+asset*1013, asset*37, version, name);
+			}
+		}
+
+		_bench_append(&page, ",{\"url\":\"https://api.github.com/repos/electron/electron/releases/assets/1\",\"id\":1,\"node_id\":\"RA_1\",\"name\":\"SHASUMS256.txt\",\"label\":\"\",\"uploader\":%s,"
+			"\"content_type\":\"text/plain\",\"state\":\"uploaded\",\"size\":9000,\"download_count\":12,\"created_at\":\"2024-05-01T16:31:42Z\",\"updated_at\":\"2024-05-01T16:31:43Z\","
+			"\"browser_download_url\":\"https://github.com/electron/electron/releases/download/v%s/SHASUMS256.txt\"}],", uploader, version);
+
+		_bench_append(&page, "\"tarball_url\":\"https://api.github.com/repos/electron/electron/tarball/v%s\",\"zipball_url\":\"https://api.github.com/repos/electron/electron/zipball/v%s\",\"body\":\"# Release Notes for v%s\\r\\n\\r\\n", version, version, version);
+		for(int note=0; note<40; note++){
+			_bench_append(&page, "* Fixed an issue where `webContents.print()` with \\\"silent: true\\\" ignored the {margins} [option]. #%i <span style=\\\"font-size:small;\\\">(Also in [29](https://github.com/electron/electron/pull/%i))</span>\\r\\n", 41000+note, 41100+note);
+		}
+		_bench_append(&page, "\"}");
+	}
+
+	_bench_append(&page, "]");
+
+	*length = page.length;
+	return page.data;
+}
+
+static char *_bench_read(const char *filename, size_t *length) {
+	FILE *file = fopen(filename, "rb");
+	if(!file) return NULL;
+
+	fseek(file, 0, SEEK_END);
+	*length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	char *data = malloc(*length+1);
+	*length = fread(data, 1, *length, file);
+	data[*length] = '\0';
+	fclose(file);
+
+	return data;
+}
+
+// what each way found, so they can be checked against each other
+typedef struct {
+	unsigned count;
+	char best[64];
+} _Bench_result;
+
+static void _bench_consider(_Bench_result *result, const char *name, size_t nameLength, const char *type, size_t typeLength) {
+	const char *endName = "-" BUILDARCHSTRING ".zip";
+	size_t endNameLength = strlen(endName);
+
+	if(nameLength<=9+endNameLength || strncmp("electron-", name, 9) || strncmp(endName, name+nameLength-endNameLength, endNameLength)) return;
+	if(typeLength!=15 || strncmp("application/zip", type, 15)) return;
+
+	char versionString[64];
+	snprintf(versionString, sizeof(versionString), "%.*s", (int)(nameLength-9-endNameLength-1), name+10);
+
+	Version version;
+	Version best;
+	if(!version_parse(versionString, &version)) return;
+
+	result->count++;
+	if(!result->best[0] || !version_parse(result->best, &best) || version_compare(&version, &best)>0){
+		snprintf(result->best, sizeof(result->best), "%s", versionString);
+	}
+}
+
+// the original json_init(), counting the tokens with one parse and filling them in with another
+static int _baseline_json_init(jsmn_parser *jsonParser, jsmntok_t *json[], const char *data, size_t dataLength) {
+	jsmn_init(jsonParser);
+	int size = jsmn_parse(jsonParser, data, dataLength, NULL, 0);
+	if(size<=0){
+		*json = NULL;
+		return 0;
+	}
+
+	*json = malloc(size*sizeof(jsmntok_t));
+
+	jsmn_init(jsonParser);
+	return jsmn_parse(jsonParser, data, dataLength, *json, size);
+}
+
+static void _baseline_json_next(jsmntok_t json[], int jsonLength, int *position) {
+	for(int skipTo=json[*position].end; *position<jsonLength&&json[*position].start<=skipTo; (*position)++);
+}
+
+static bool _baseline_json_find(jsmntok_t json[], int jsonLength, const char *data, int parent, int *_position, const char *name, jsmntype_t type) {
+	int position = *_position;
+	int maxByte = json[parent].end;
+	int nameLength = strlen(name);
+
+	while(position<jsonLength&&json[position].start<maxByte){
+		if(json[position].end-json[position].start==nameLength && !strncmp(name, &data[json[position].start], nameLength)){
+			++position;
+
+			if(json[position].type==type || type==JSMN_STRING && json[position].type==JSMN_PRIMITIVE){
+				*_position = position;
+				return true;
+			}else{
+				return false;
+			}
+		}
+
+		_baseline_json_next(json, jsonLength, &position);
+	}
+
+	return false;
+}
+
+static void _bench_baseline(const char *data, size_t length, _Bench_result *result) {
+	jsmn_parser parser;
+	jsmntok_t *json;
+	int parsed = _baseline_json_init(&parser, &json, data, length);
+
+	for(int position=1; position<parsed;){
+		int releasePosition = position;
+
+		int assetsPosition = releasePosition+1;
+		if(json[releasePosition].type==JSMN_OBJECT && _baseline_json_find(json, parsed, data, releasePosition, &assetsPosition, "assets", JSMN_ARRAY)){
+			int afterAssets = assetsPosition;
+			_baseline_json_next(json, parsed, &afterAssets);
+
+			for(int assetPosition=assetsPosition+1; assetPosition<afterAssets; _baseline_json_next(json, parsed, &assetPosition)){
+				int namePosition = assetPosition+1;
+				int typePosition = assetPosition+1;
+				if(
+					_baseline_json_find(json, parsed, data, assetPosition, &namePosition, "name", JSMN_STRING) &&
+					_baseline_json_find(json, parsed, data, assetPosition, &typePosition, "content_type", JSMN_STRING)
+				){
+					_bench_consider(result, data+json[namePosition].start, json[namePosition].end-json[namePosition].start, data+json[typePosition].start, json[typePosition].end-json[typePosition].start);
+				}
+			}
+		}
+
+		_baseline_json_next(json, parsed, &position);
+	}
+
+	free(json);
+}
+
+static void _bench_indexed(const char *data, size_t length, _Bench_result *result) {
+	jsmn_parser parser;
+	jsmntok_t *json;
+	int parsed = json_init_length(&parser, &json, data, length);
+
+	for(int position=1; position<parsed; json_next(json, parsed, &position)){
+		int assetsPosition = json_query(json, parsed, data, position, "assets", JSMN_ARRAY);
+		if(assetsPosition<0) continue;
+
+		int afterAssets = assetsPosition;
+		json_next(json, parsed, &afterAssets);
+
+		for(int assetPosition=assetsPosition+1; assetPosition<afterAssets; json_next(json, parsed, &assetPosition)){
+			int namePosition = json_query(json, parsed, data, assetPosition, "name", JSMN_STRING);
+			int typePosition = json_query(json, parsed, data, assetPosition, "content_type", JSMN_STRING);
+			if(namePosition>=0 && typePosition>=0){
+				_bench_consider(result, data+json[namePosition].start, json[namePosition].end-json[namePosition].start, data+json[typePosition].start, json[typePosition].end-json[typePosition].start);
+			}
+		}
+	}
+}
+
+static void _bench_streamed(const char *data, size_t length, _Bench_result *result) {
+	Version_range range;
+	version_range_compile(&range, "*");
+
+	_Release_search search = {.range = &range};
+	_Release_page *page = calloc(1, sizeof(_Release_page));
+
+	//fed as curl hands it over
+	_on_release_data(page, NULL, 0, &search);
+	for(size_t offset=0; offset<length; offset+=CURL_MAX_WRITE_SIZE){
+		_on_release_data(page, data+offset, MIN(CURL_MAX_WRITE_SIZE, length-offset), &search);
+	}
+	json_stream_finish(&page->json);
+
+	//the scanner only keeps the best, so there's no count to compare
+	result->count = 0;
+	snprintf(result->best, sizeof(result->best), "%s", page->bestString);
+
+	free(page);
+	version_range_free(&range);
+}
+
+static double _bench_run(const char *label, void (*run)(const char*, size_t, _Bench_result*), const char *data, size_t length, _Bench_result *result) {
+	double fastest = 1e9;
+
+	for(int i=0; i<BENCH_RUNS; i++){
+		memset(result, 0, sizeof(*result));
+
+		double start = _bench_time();
+		run(data, length, result);
+		fastest = MIN(fastest, _bench_time()-start);
+	}
+
+	printf("  %-36s %8.2f ms  %7.1f MB/s  (%u matches, best %s)\n", label, fastest*1000, length/fastest/1e6, result->count, result->best);
+	return fastest;
+}
+
+// looking up one value by its path, as read_file_asar() and the project's package.json are
+static void _bench_lookup(const char *data, size_t length) {
+	jsmn_parser parser;
+	jsmntok_t *baselineJson;
+	int baselineParsed = _baseline_json_init(&parser, &baselineJson, data, length);
+
+	jsmntok_t *json;
+	int parsed = json_init_length(&parser, &json, data, length);
+
+	const int lookups = 10000;
+	volatile int sink = 0;
+
+	double start = _bench_time();
+	for(int i=0; i<lookups; i++){
+		//the last release, so everything before it is walked past
+		int release = 1;
+		for(int skip=0; skip<99; skip++) _baseline_json_next(baselineJson, baselineParsed, &release);
+
+		int tag = release+1;
+		if(_baseline_json_find(baselineJson, baselineParsed, data, release, &tag, "tag_name", JSMN_STRING)) sink += tag;
+	}
+	double baseline = _bench_time()-start;
+
+	start = _bench_time();
+	for(int i=0; i<lookups; i++){
+		sink += json_query(json, parsed, data, 0, "99.tag_name", JSMN_STRING);
+	}
+	double indexed = _bench_time()-start;
+
+	printf("  %-36s %8.2f us\n", "json_find(), 100th release's tag", baseline/lookups*1e6);
+	printf("  %-36s %8.2f us\n", "json_query(\"99.tag_name\")", indexed/lookups*1e6);
+
+	free(baselineJson);
+}
+
+int main(int argc, char *argv[]) {
+	size_t length;
+	char *data = argc>1?_bench_read(argv[1], &length):_bench_make_page(&length);
+	if(!data){
+		fprintf(stderr, "Unable to read \"%s\"\n", argv[1]);
+		return 1;
+	}
+
+	printf("%s: %.1f MB, best of %i runs\n", argc>1?argv[1]:"made up page of 100 releases", length/1e6, BENCH_RUNS);
+
+	_Bench_result baseline;
+	_Bench_result indexed;
+	_Bench_result streamed;
+	_bench_run("double parse, json_find()", _bench_baseline, data, length, &baseline);
+	_bench_run("arena parse, json_query()", _bench_indexed, data, length, &indexed);
+	_bench_run("streaming scanner (as shipped)", _bench_streamed, data, length, &streamed);
+	_bench_lookup(data, length);
+
+	free(data);
+
+	bool agree = baseline.count==indexed.count && !strcmp(baseline.best, indexed.best) && !strcmp(baseline.best, streamed.best);
+	if(!agree){
+		fprintf(stderr, "The results differ\n");
+		return 1;
+	}
+
+	return 0;
+}
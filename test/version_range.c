@@ -0,0 +1,374 @@
+// checks version_parse(), version_compare() and version_range_compile()/version_range_test() against the test vectors of npm's semver package
+// (test/fixtures/range-include.js, range-exclude.js, comparisons.js and equality.js)
+// requirements are read as npm reads them by default, so vectors needing its `loose` or `includePrerelease` options are skipped
+
+#define main electron_shared_main
+#include "../source/main.c"
+#undef main
+
+#define LOOSE              1
+#define INCLUDE_PRERELEASE 2
+
+typedef struct {
+	const char *range;
+	const char *version;
+	int options;
+} _Range_vector;
+
+// each version satisfies its range
+static const _Range_vector _rangeInclude[] = {
+	{"1.0.0 - 2.0.0", "1.2.3"},
+	{"^1.2.3+build", "1.2.3"},
+	{"^1.2.3+build", "1.3.0"},
+	{"1.2.3-pre+asdf - 2.4.3-pre+asdf", "1.2.3"},
+	{"1.2.3pre+asdf - 2.4.3-pre+asdf", "1.2.3", LOOSE},
+	{"1.2.3-pre+asdf - 2.4.3pre+asdf", "1.2.3", LOOSE},
+	{"1.2.3-pre+asdf - 2.4.3-pre+asdf", "1.2.3-pre.2"},
+	{"1.2.3-pre+asdf - 2.4.3-pre+asdf", "2.4.3-alpha"},
+	{"1.2.3+asdf - 2.4.3+asdf", "1.2.3"},
+	{"1.0.0", "1.0.0"},
+	{">=*", "0.2.4"},
+	{"", "1.0.0"},
+	{"*", "1.2.3"},
+	{"*", "v1.2.3", LOOSE},
+	{">=1.0.0", "1.0.0"},
+	{">=1.0.0", "1.0.1"},
+	{">=1.0.0", "1.1.0"},
+	{">1.0.0", "1.0.1"},
+	{">1.0.0", "1.1.0"},
+	{"<=2.0.0", "2.0.0"},
+	{"<=2.0.0", "1.9999.9999"},
+	{"<=2.0.0", "0.2.9"},
+	{"<2.0.0", "1.9999.9999"},
+	{"<2.0.0", "0.2.9"},
+	{">= 1.0.0", "1.0.0"},
+	{">=  1.0.0", "1.0.1"},
+	{">=   1.0.0", "1.1.0"},
+	{"> 1.0.0", "1.0.1"},
+	{">  1.0.0", "1.1.0"},
+	{"<=   2.0.0", "2.0.0"},
+	{"<= 2.0.0", "1.9999.9999"},
+	{"<=  2.0.0", "0.2.9"},
+	{"<    2.0.0", "1.9999.9999"},
+	{"<\t2.0.0", "0.2.9"},
+	{">=0.1.97", "v0.1.97", LOOSE},
+	{">=0.1.97", "0.1.97"},
+	{"0.1.20 || 1.2.4", "1.2.4"},
+	{">=0.2.3 || <0.0.1", "0.0.0"},
+	{">=0.2.3 || <0.0.1", "0.2.3"},
+	{">=0.2.3 || <0.0.1", "0.2.4"},
+	{"||", "1.3.4"},
+	{"2.x.x", "2.1.3"},
+	{"1.2.x", "1.2.3"},
+	{"1.2.x || 2.x", "2.1.3"},
+	{"1.2.x || 2.x", "1.2.3"},
+	{"x", "1.2.3"},
+	{"2.*.*", "2.1.3"},
+	{"1.2.*", "1.2.3"},
+	{"1.2.* || 2.*", "2.1.3"},
+	{"1.2.* || 2.*", "1.2.3"},
+	{"*", "1.2.3"},
+	{"2", "2.1.2"},
+	{"2.3", "2.3.1"},
+	{"~0.0.1", "0.0.1"},
+	{"~0.0.1", "0.0.2"},
+	{"~x", "0.0.9"},
+	{"~2", "2.0.9"},
+	{"~2.4", "2.4.0"},
+	{"~2.4", "2.4.5"},
+	{"~>3.2.1", "3.2.2"},
+	{"~1", "1.2.3"},
+	{"~>1", "1.2.3"},
+	{"~> 1", "1.2.3"},
+	{"~1.0", "1.0.2"},
+	{"~ 1.0", "1.0.2"},
+	{"~ 1.0.3", "1.0.12"},
+	{"~ 1.0.3alpha", "1.0.12", LOOSE},
+	{">=1", "1.0.0"},
+	{">= 1", "1.0.0"},
+	{"<1.2", "1.1.1"},
+	{"< 1.2", "1.1.1"},
+	{"~v0.5.4-pre", "0.5.5"},
+	{"~v0.5.4-pre", "0.5.4"},
+	{"=0.7.x", "0.7.2"},
+	{"<=0.7.x", "0.7.2"},
+	{">=0.7.x", "0.7.2"},
+	{"<=0.7.x", "0.6.2"},
+	{"~1.2.1 >=1.2.3", "1.2.3"},
+	{"~1.2.1 =1.2.3", "1.2.3"},
+	{"~1.2.1 1.2.3", "1.2.3"},
+	{"~1.2.1 >=1.2.3 1.2.3", "1.2.3"},
+	{"~1.2.1 1.2.3 >=1.2.3", "1.2.3"},
+	{">=1.2.1 1.2.3", "1.2.3"},
+	{"1.2.3 >=1.2.1", "1.2.3"},
+	{">=1.2.3 >=1.2.1", "1.2.3"},
+	{">=1.2.1 >=1.2.3", "1.2.3"},
+	{">=1.2", "1.2.8"},
+	{"^1.2.3", "1.8.1"},
+	{"^0.1.2", "0.1.2"},
+	{"^0.1", "0.1.2"},
+	{"^0.0.1", "0.0.1"},
+	{"^1.2", "1.4.2"},
+	{"^1.2 ^1", "1.4.2"},
+	{"^1.2.3-alpha", "1.2.3-pre"},
+	{"^1.2.0-alpha", "1.2.0-pre"},
+	{"^0.0.1-alpha", "0.0.1-beta"},
+	{"^0.0.1-alpha", "0.0.1"},
+	{"^0.1.1-alpha", "0.1.1-beta"},
+	{"^x", "1.2.3"},
+	{"x - 1.0.0", "0.9.7"},
+	{"x - 1.x", "0.9.7"},
+	{"1.0.0 - x", "1.9.7"},
+	{"1.x - x", "1.9.7"},
+	{"<=7.x", "7.9.9"},
+	{"2.x", "2.0.0-pre.0", INCLUDE_PRERELEASE},
+	{"2.x", "2.1.0-pre.0", INCLUDE_PRERELEASE},
+	{"1.1.x", "1.1.0-a", INCLUDE_PRERELEASE},
+	{"1.1.x", "1.1.1-a", INCLUDE_PRERELEASE},
+	{"*", "1.0.0-rc1", INCLUDE_PRERELEASE},
+	{"^1.0.0-0", "1.0.1-rc1", INCLUDE_PRERELEASE},
+	{"^1.0.0-rc2", "1.0.1-rc1", INCLUDE_PRERELEASE},
+	{"^1.0.0", "1.0.1-rc1", INCLUDE_PRERELEASE},
+	{"^1.0.0", "1.1.0-rc1", INCLUDE_PRERELEASE},
+	{"1 - 2", "2.0.0-pre", INCLUDE_PRERELEASE},
+	{"1 - 2", "1.0.0-pre", INCLUDE_PRERELEASE},
+	{"1.0 - 2", "1.0.0-pre", INCLUDE_PRERELEASE},
+	{"=0.7.x", "0.7.0-asdf", INCLUDE_PRERELEASE},
+	{">=0.7.x", "0.7.0-asdf", INCLUDE_PRERELEASE},
+	{"<=0.7.x", "0.7.0-asdf", INCLUDE_PRERELEASE},
+	{">=1.0.0 <=1.1.0", "1.1.0-pre", INCLUDE_PRERELEASE}
+};
+
+// each version doesn't satisfy its range (versions that aren't valid included)
+static const _Range_vector _rangeExclude[] = {
+	{"1.0.0 - 2.0.0", "2.2.3"},
+	{"1.2.3+asdf - 2.4.3+asdf", "1.2.3-pre.2"},
+	{"1.2.3+asdf - 2.4.3+asdf", "2.4.3-alpha"},
+	{"^1.2.3+build", "2.0.0"},
+	{"^1.2.3+build", "1.2.0"},
+	{"^1.2.3", "1.2.3-pre"},
+	{"^1.2", "1.2.0-pre"},
+	{">1.2", "1.3.0-beta"},
+	{"<=1.2.3", "1.2.3-beta"},
+	{"^1.2.3", "1.2.3-beta"},
+	{"=0.7.x", "0.7.0-asdf"},
+	{">=0.7.x", "0.7.0-asdf"},
+	{"<=0.7.x", "0.7.0-asdf"},
+	{"1", "1.0.0beta", LOOSE},
+	{"<1", "1.0.0beta", LOOSE},
+	{"< 1", "1.0.0beta", LOOSE},
+	{"1.0.0", "1.0.1"},
+	{">=1.0.0", "0.0.0"},
+	{">=1.0.0", "0.0.1"},
+	{">=1.0.0", "0.1.0"},
+	{">1.0.0", "0.0.1"},
+	{">1.0.0", "0.1.0"},
+	{"<=2.0.0", "3.0.0"},
+	{"<=2.0.0", "2.9999.9999"},
+	{"<=2.0.0", "2.2.9"},
+	{"<2.0.0", "2.9999.9999"},
+	{"<2.0.0", "2.2.9"},
+	{">=0.1.97", "v0.1.93", LOOSE},
+	{">=0.1.97", "0.1.93"},
+	{"0.1.20 || 1.2.4", "1.2.3"},
+	{">=0.2.3 || <0.0.1", "0.0.3"},
+	{">=0.2.3 || <0.0.1", "0.2.2"},
+	{"2.x.x", "1.1.3", LOOSE},
+	{"2.x.x", "3.1.3"},
+	{"1.2.x", "1.3.3"},
+	{"1.2.x || 2.x", "3.1.3"},
+	{"1.2.x || 2.x", "1.1.3"},
+	{"2.*.*", "1.1.3"},
+	{"2.*.*", "3.1.3"},
+	{"1.2.*", "1.3.3"},
+	{"1.2.* || 2.*", "3.1.3"},
+	{"1.2.* || 2.*", "1.1.3"},
+	{"2", "1.1.2"},
+	{"2.3", "2.4.1"},
+	{"~0.0.1", "0.1.0-alpha"},
+	{"~0.0.1", "0.1.0"},
+	{"~2.4", "2.5.0"},
+	{"~2.4", "2.3.9"},
+	{"~>3.2.1", "3.3.2"},
+	{"~>3.2.1", "3.2.0"},
+	{"~1", "0.2.3"},
+	{"~>1", "2.2.3"},
+	{"~1.0", "1.1.0"},
+	{"<1", "1.0.0"},
+	{">=1.2", "1.1.1"},
+	{"1", "2.0.0beta", LOOSE},
+	{"~v0.5.4-beta", "0.5.4-alpha"},
+	{"=0.7.x", "0.8.2"},
+	{">=0.7.x", "0.6.2"},
+	{"<0.7.x", "0.7.2"},
+	{"<1.2.3", "1.2.3-beta"},
+	{"=1.2.3", "1.2.3-beta"},
+	{">1.2", "1.2.8"},
+	{"^0.0.1", "0.0.2-alpha"},
+	{"^0.0.1", "0.0.2"},
+	{"^1.2.3", "2.0.0-alpha"},
+	{"^1.2.3", "1.2.2"},
+	{"^1.2", "1.1.9"},
+	{"*", "v1.2.3-foo", LOOSE},
+	{"*", "not a version"},
+	{">=2", "glorp"},
+	{"2.x", "3.0.0-pre.0", INCLUDE_PRERELEASE},
+	{"^1.0.0", "1.0.0-rc1", INCLUDE_PRERELEASE},
+	{"^1.0.0", "2.0.0-rc1", INCLUDE_PRERELEASE},
+	{"^1.2.3-rc2", "2.0.0", INCLUDE_PRERELEASE},
+	{"^1.0.0", "2.0.0-rc1"},
+	{"1 - 2", "3.0.0-pre", INCLUDE_PRERELEASE},
+	{"1 - 2", "2.0.0-pre"},
+	{"1 - 2", "1.0.0-pre"},
+	{"1.0 - 2", "1.0.0-pre"},
+	{"1.1.x", "1.0.0-a"},
+	{"1.1.x", "1.1.0-a"},
+	{"1.1.x", "1.2.0-a"},
+	{"1.x", "1.0.0-a"},
+	{"1.x", "1.1.0-a"},
+	{"1.x", "1.2.0-a"},
+	{">=1.0.0 <1.1.0", "1.1.0"},
+	{">=1.0.0 <1.1.0", "1.1.0-pre"},
+	{">=1.0.0 <1.1.0-pre", "1.1.0-pre"},
+	{"== 1.0.0 || foo", "2.0.0", LOOSE}
+};
+
+typedef struct {
+	const char *greater;
+	const char *lesser;
+	int options;
+} _Compare_vector;
+
+// the first version of each is greater than the second
+static const _Compare_vector _comparisons[] = {
+	{"0.0.0", "0.0.0-foo"},
+	{"0.0.1", "0.0.0"},
+	{"1.0.0", "0.9.9"},
+	{"0.10.0", "0.9.0"},
+	{"0.99.0", "0.10.0"},
+	{"2.0.0", "1.2.3"},
+	{"v0.0.0", "0.0.0-foo", LOOSE},
+	{"v0.0.1", "0.0.0", LOOSE},
+	{"v1.0.0", "0.9.9", LOOSE},
+	{"v0.10.0", "0.9.0", LOOSE},
+	{"v0.99.0", "0.10.0", LOOSE},
+	{"v2.0.0", "1.2.3", LOOSE},
+	{"0.0.0", "v0.0.0-foo", LOOSE},
+	{"0.0.1", "v0.0.0", LOOSE},
+	{"1.0.0", "v0.9.9", LOOSE},
+	{"0.10.0", "v0.9.0", LOOSE},
+	{"0.99.0", "v0.10.0", LOOSE},
+	{"2.0.0", "v1.2.3", LOOSE},
+	{"1.2.3", "1.2.3-asdf"},
+	{"1.2.3", "1.2.3-4"},
+	{"1.2.3", "1.2.3-4-foo"},
+	{"1.2.3-5-foo", "1.2.3-5"},
+	{"1.2.3-5", "1.2.3-4"},
+	{"1.2.3-5-foo", "1.2.3-5-Foo"},
+	{"3.0.0", "2.7.2+asdf"},
+	{"1.2.3-a.10", "1.2.3-a.5"},
+	{"1.2.3-a.b", "1.2.3-a.5"},
+	{"1.2.3-a.b", "1.2.3-a"},
+	{"1.2.3-a.b.c.10.d.5", "1.2.3-a.b.c.5.d.100"},
+	{"1.2.3-r2", "1.2.3-r100"},
+	{"1.2.3-r100", "1.2.3-R2"}
+};
+
+// the two versions of each are equal
+static const _Compare_vector _equalities[] = {
+	{"1.2.3", "v1.2.3", LOOSE},
+	{"1.2.3", "=1.2.3", LOOSE},
+	{"1.2.3", "v 1.2.3", LOOSE},
+	{"1.2.3", "= 1.2.3", LOOSE},
+	{"1.2.3", " v1.2.3", LOOSE},
+	{"1.2.3", " =1.2.3", LOOSE},
+	{"1.2.3", " v 1.2.3", LOOSE},
+	{"1.2.3", " = 1.2.3", LOOSE},
+	{"1.2.3-0", "v1.2.3-0", LOOSE},
+	{"1.2.3-0", "=1.2.3-0", LOOSE},
+	{"1.2.3-0", "v 1.2.3-0", LOOSE},
+	{"1.2.3-0", "= 1.2.3-0", LOOSE},
+	{"1.2.3-1", "v1.2.3-1", LOOSE},
+	{"1.2.3-1", "=1.2.3-1", LOOSE},
+	{"1.2.3-beta", "v1.2.3-beta", LOOSE},
+	{"1.2.3-beta", "=1.2.3-beta", LOOSE},
+	{"1.2.3-beta+build", " = 1.2.3-beta+otherbuild", LOOSE},
+	{"1.2.3+build", " = 1.2.3+otherbuild", LOOSE},
+	{"1.2.3-beta+build", "1.2.3-beta+otherbuild"},
+	{"1.2.3+build", "1.2.3+otherbuild"},
+	{"  v1.2.3+build", "1.2.3+otherbuild"}
+};
+
+static unsigned _failures = 0;
+static unsigned _skipped = 0;
+
+static void _check_ranges(const _Range_vector *vectors, size_t count, bool included) {
+	for(size_t i=0; i<count; i++){
+		const _Range_vector *vector = &vectors[i];
+		if(vector->options){
+			_skipped++;
+			continue;
+		}
+
+		Version_range range;
+		if(!version_range_compile(&range, vector->range)){
+			//npm takes an unreadable range to match nothing
+			if(included){
+				fprintf(stderr, "FAIL: \"%s\" can't be read, but should include %s\n", vector->range, vector->version);
+				_failures++;
+			}
+			continue;
+		}
+
+		Version version;
+		bool result = version_parse(vector->version, &version) && version_range_test(&range, &version);
+		if(result!=included){
+			fprintf(stderr, "FAIL: \"%s\" should %s %s\n", vector->range, included?"include":"exclude", vector->version);
+			_failures++;
+		}
+
+		version_range_free(&range);
+	}
+}
+
+static void _check_comparisons(const _Compare_vector *vectors, size_t count, bool equal) {
+	for(size_t i=0; i<count; i++){
+		const _Compare_vector *vector = &vectors[i];
+		if(vector->options){
+			_skipped++;
+			continue;
+		}
+
+		//surrounding space is only allowed loosely, but npm trims it regardless
+		const char *a = vector->greater;
+		const char *b = vector->lesser;
+		while(*a==' ') a++;
+		while(*b==' ') b++;
+
+		Version versionA;
+		Version versionB;
+		if(!version_parse(a, &versionA) || !version_parse(b, &versionB)){
+			fprintf(stderr, "FAIL: %s or %s can't be read\n", vector->greater, vector->lesser);
+			_failures++;
+			continue;
+		}
+
+		int expected = equal?0:1;
+		if(version_compare(&versionA, &versionB)!=expected || version_compare(&versionB, &versionA)!=-expected){
+			fprintf(stderr, "FAIL: %s should be %s %s\n", vector->greater, equal?"equal to":"greater than", vector->lesser);
+			_failures++;
+		}
+	}
+}
+
+int main() {
+	_check_ranges(_rangeInclude, sizeof(_rangeInclude)/sizeof(_rangeInclude[0]), true);
+	_check_ranges(_rangeExclude, sizeof(_rangeExclude)/sizeof(_rangeExclude[0]), false);
+	_check_comparisons(_comparisons, sizeof(_comparisons)/sizeof(_comparisons[0]), false);
+	_check_comparisons(_equalities, sizeof(_equalities)/sizeof(_equalities[0]), true);
+
+	size_t total = sizeof(_rangeInclude)/sizeof(_rangeInclude[0])+sizeof(_rangeExclude)/sizeof(_rangeExclude[0])+sizeof(_comparisons)/sizeof(_comparisons[0])+sizeof(_equalities)/sizeof(_equalities[0]);
+	printf("version_range: %u of %zu failed (%u skipped, needing loose or includePrerelease)\n", _failures, total-_skipped, _skipped);
+
+	return _failures?1:0;
+}